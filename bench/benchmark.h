@@ -0,0 +1,82 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+/*
+    Minimal benchmark harness. Every iteration runs setup() untimed and
+    body() timed, iterations are added until MIN_BENCHMARK_TIME of timed
+    work was collected, or MAX_BENCHMARK_TIME passed when setup dominates.
+*/
+
+const double MIN_BENCHMARK_TIME = 0.5; // seconds
+const double MAX_BENCHMARK_TIME = 5; // seconds
+volatile double benchmark_sink = 0;
+
+template<typename T>
+void do_not_optimize(const T& value) {
+    benchmark_sink = benchmark_sink + static_cast<double>(value);
+}
+
+template<typename Setup, typename Body>
+void run_benchmark(const std::string& name, Setup setup, Body body, double bytes_per_iteration = 0) {
+    setup();
+    body(); // warm up
+
+    double total = 0;
+    long iterations = 0;
+    auto benchmark_start = std::chrono::steady_clock::now();
+    while(total < MIN_BENCHMARK_TIME
+          && std::chrono::duration<double>(std::chrono::steady_clock::now() - benchmark_start).count() < MAX_BENCHMARK_TIME) {
+        setup();
+        auto start = std::chrono::steady_clock::now();
+        body();
+        auto end = std::chrono::steady_clock::now();
+        total += std::chrono::duration<double>(end - start).count();
+        iterations++;
+    }
+
+    double nanoseconds = total/iterations*1e9;
+    if(bytes_per_iteration > 0) {
+        double megabytes_per_second = bytes_per_iteration*iterations/total/(1024*1024);
+        std::printf("%-32s %14.0f ns %10ld iterations %10.2f MB/s\n", name.c_str(), nanoseconds, iterations, megabytes_per_second);
+    } else {
+        std::printf("%-32s %14.0f ns %10ld iterations\n", name.c_str(), nanoseconds, iterations);
+    }
+}
+
+template<typename Body>
+void run_benchmark(const std::string& name, Body body, double bytes_per_iteration = 0) {
+    run_benchmark(name, [] {}, body, bytes_per_iteration);
+}
+
+// uniform random k-SAT in DIMACS format, the same seed gives the same formula
+std::string generate_cnf(int variables, int clauses, int width, unsigned seed) {
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<int> variable_distribution(1, variables);
+    std::uniform_int_distribution<int> sign_distribution(0, 1);
+
+    std::string result = "c generated with seed " + std::to_string(seed) + "\n";
+    result += "p cnf " + std::to_string(variables) + " " + std::to_string(clauses) + "\n";
+    for(int i=0; i<clauses; i++) {
+        std::vector<int> clause;
+        while(static_cast<int>(clause.size()) < width) {
+            int variable = variable_distribution(generator);
+            if(std::find(clause.begin(), clause.end(), variable) == clause.end()) {
+                clause.push_back(variable);
+            }
+        }
+        for(auto variable: clause) {
+            result += std::to_string(sign_distribution(generator) ? variable : -variable) + " ";
+        }
+        result += "0\n";
+    }
+    return result;
+}
+
+#endif
@@ -0,0 +1,250 @@
+/*
+    Microbenchmarks of the solver kernels on generated random k-SAT.
+
+    Build from the repository root:
+        g++ -std=c++17 -O2 -pthread bench/kernels.cpp -o kernels
+    Run:
+        ./kernels [seed] [variables] [width] [clauses]
+
+    The settings macros (DIFF_HEURISTIC, ...) can be passed with -D like for
+    the solver. All inputs depend only on the arguments.
+*/
+#include "../includes.h"
+#include "../settings.h"
+#include "../variable.h"
+#include "../reader.h"
+#include "../preselect_heap.h"
+#include "../fixed_clause.h"
+#include "../sat_class.h"
+#include "../bit_sat_class.h"
+#include "../two_sat.h"
+#include "../local_search.h"
+#include "../checkpoint.h"
+#include "../solver.h"
+#include "benchmark.h"
+
+void read_formula(const std::string& source, std::unordered_map<int, std::unordered_set<int>>& formula,
+                  std::unordered_map<int, Variable>& variables, std::unordered_set<int>& unsigned_variables,
+                  std::unordered_map<int, PairsSet>& binary_clauses, int& number_of_clauses,
+                  std::unordered_map<int, double>& literal_weights, std::unordered_map<int, int>& literal_count) {
+    std::istringstream in(source);
+    auto standard_input = std::cin.rdbuf(in.rdbuf());
+    read_input(formula, variables, unsigned_variables, binary_clauses, number_of_clauses, literal_weights, literal_count);
+    std::cin.rdbuf(standard_input);
+}
+
+// applies decisions from the trail until count of them succeeded, conflicting ones are skipped
+template<typename Instance>
+Instance apply_trail(const Instance& root, const std::vector<std::pair<int, bool>>& trail, int count) {
+    auto instance = root;
+    int applied = 0;
+    for(auto decision: trail) {
+        if(applied == count) {
+            break;
+        }
+        if(instance.variables[decision.first].value != -1) {
+            continue;
+        }
+        auto next = instance;
+        next.decision_level += 1;
+        if(next.propagation(decision.first, decision.second)) {
+            instance = next;
+            applied++;
+        }
+    }
+    return instance;
+}
+
+int first_unassigned(SATclass& instance, const std::vector<std::pair<int, bool>>& trail) {
+    for(auto decision: trail) {
+        if(instance.variables[decision.first].value == -1) {
+            return decision.first;
+        }
+    }
+    return trail.front().first;
+}
+
+int main(int argc, char* argv[]) {
+    unsigned seed = argc > 1 ? std::stoul(argv[1]) : 1;
+    int variables_number = argc > 2 ? std::stoi(argv[2]) : 2000;
+    int width = argc > 3 ? std::stoi(argv[3]) : 3;
+    int clauses_number = argc > 4 ? std::stoi(argv[4]) : 4.26*variables_number;
+
+    auto source = generate_cnf(variables_number, clauses_number, width, seed);
+    std::printf("seed %u, %d variables, %d clauses of width %d\n", seed, variables_number, clauses_number, width);
+
+    auto formula = std::unordered_map<int, std::unordered_set<int>>();
+    auto variables = std::unordered_map<int, Variable>();
+    auto unasigned_variables = std::unordered_set<int>();
+    auto binary_clauses = std::unordered_map<int, PairsSet>();
+    auto literal_wieghts = std::unordered_map<int, double>();
+    auto literal_count = std::unordered_map<int, int>();
+    int number_of_clauses = 0;
+
+    run_benchmark("read_input", [&] {
+        formula = {}; variables = {}; unasigned_variables = {}; binary_clauses = {}; literal_wieghts = {}; literal_count = {};
+    }, [&] {
+        read_formula(source, formula, variables, unasigned_variables, binary_clauses, number_of_clauses, literal_wieghts, literal_count);
+    }, source.size());
+
+    auto root = SATclass(unasigned_variables, variables, formula, binary_clauses, number_of_clauses, literal_wieghts, literal_count);
+    root.trigger = 65;
+    root.start_tigger = 65;
+
+    // fixed trail: a random order of the variables with random values
+    std::mt19937 generator(seed);
+    auto trail = std::vector<std::pair<int, bool>>();
+    for(int i=1; i<=variables_number; i++) {
+        trail.push_back(std::make_pair(i, generator() % 2 == 0));
+    }
+    std::shuffle(trail.begin(), trail.end(), generator);
+
+    auto node = apply_trail(root, trail, 5);
+    int variable = first_unassigned(node, trail);
+    auto true_child = node;
+    auto false_child = node;
+    true_child.propagation(variable, 1);
+    false_child.propagation(variable, 0);
+    std::printf("node: %zu unassigned variables, %zu clauses left\n", node.unsigned_variables.size(), node.formula.size());
+
+    auto scratch = root;
+    run_benchmark("propagation (trail of 5)", [&] { scratch = root; }, [&] {
+        int applied = 0;
+        for(auto decision: trail) {
+            if(applied == 5) {
+                break;
+            }
+            if(scratch.variables[decision.first].value == -1) {
+                if(!scratch.propagation(decision.first, decision.second)) {
+                    break;
+                }
+                applied++;
+            }
+        }
+        do_not_optimize(applied);
+    });
+    run_benchmark("propagation (single literal)", [&] { scratch = node; }, [&] {
+        do_not_optimize(scratch.propagation(variable, 1));
+    });
+
+    run_benchmark("preselect_propz", [&] {
+        do_not_optimize(node.preselect_propz().size());
+    });
+    run_benchmark("preselect_cra", [&] {
+        do_not_optimize(node.preselect_cra().size());
+    });
+
+    // the calls above leave nothing to refresh, in the search a state copy brings the changes of one propagation
+    auto pending = node;
+    pending.propagation(variable, 1);
+    std::printf("pending: %zu changed literals\n", pending.changed_literals.size());
+    run_benchmark("preselect_propz (changes pending)", [&] { scratch = pending; }, [&] {
+        do_not_optimize(scratch.preselect_propz().size());
+    });
+    run_benchmark("preselect_cra (changes pending)", [&] { scratch = pending; }, [&] {
+        do_not_optimize(scratch.preselect_cra().size());
+    });
+
+    run_benchmark("count_crh", [&] { scratch = true_child; }, [&] {
+        do_not_optimize(count_crh(node, scratch));
+    });
+    run_benchmark("count_wbh", [&] { scratch = true_child; }, [&] {
+        do_not_optimize(count_wbh(node, scratch));
+    });
+    run_benchmark("count_bsh", [&] { scratch = true_child; }, [&] {
+        do_not_optimize(count_bsh(node, scratch));
+    });
+    run_benchmark("count_bsrh", [&] { scratch = true_child; }, [&] {
+        do_not_optimize(count_bsrh(node, scratch));
+    });
+    run_benchmark("recount_weights", [&] { scratch = true_child; }, [&] {
+        recount_weights(node, scratch);
+    });
+
+    run_benchmark("prepare_binary_clauses", [&] { scratch = node; }, [&] {
+        prepare_binary_clauses(scratch, true_child, variable, true);
+        prepare_binary_clauses(scratch, false_child, variable, false);
+    });
+
+    run_benchmark("state copy", [&] {
+        auto copy = node;
+        do_not_optimize(copy.number_of_all_clauses);
+    });
+    run_benchmark("state undo (assignment)", [&] { scratch = true_child; }, [&] {
+        scratch = node;
+    });
+
+    // the inline clause store main picks when no clause is wider than 3
+    if(width <= 3) {
+        auto fixed_root = BasicSATclass<FixedClause<3>>(unasigned_variables, variables, formula, binary_clauses, number_of_clauses,
+                                                        literal_wieghts, literal_count);
+        fixed_root.trigger = 65;
+        fixed_root.start_tigger = 65;
+        auto fixed_node = apply_trail(fixed_root, trail, 5);
+        auto fixed_true_child = fixed_node;
+        fixed_true_child.propagation(variable, 1);
+        auto fixed_scratch = fixed_root;
+        run_benchmark("fixed3 propagation (trail of 5)", [&] { fixed_scratch = fixed_root; }, [&] {
+            int applied = 0;
+            for(auto decision: trail) {
+                if(applied == 5) {
+                    break;
+                }
+                if(fixed_scratch.variables[decision.first].value == -1) {
+                    if(!fixed_scratch.propagation(decision.first, decision.second)) {
+                        break;
+                    }
+                    applied++;
+                }
+            }
+            do_not_optimize(applied);
+        });
+        run_benchmark("fixed3 propagation (single literal)", [&] { fixed_scratch = fixed_node; }, [&] {
+            do_not_optimize(fixed_scratch.propagation(variable, 1));
+        });
+        run_benchmark("fixed3 count_crh", [&] { fixed_scratch = fixed_true_child; }, [&] {
+            do_not_optimize(count_crh(fixed_node, fixed_scratch));
+        });
+        run_benchmark("fixed3 count_wbh", [&] { fixed_scratch = fixed_true_child; }, [&] {
+            do_not_optimize(count_wbh(fixed_node, fixed_scratch));
+        });
+        run_benchmark("fixed3 count_bsh", [&] { fixed_scratch = fixed_true_child; }, [&] {
+            do_not_optimize(count_bsh(fixed_node, fixed_scratch));
+        });
+        run_benchmark("fixed3 count_bsrh", [&] { fixed_scratch = fixed_true_child; }, [&] {
+            do_not_optimize(count_bsrh(fixed_node, fixed_scratch));
+        });
+        run_benchmark("fixed3 recount_weights", [&] { fixed_scratch = fixed_true_child; }, [&] {
+            recount_weights(fixed_node, fixed_scratch);
+        });
+        run_benchmark("fixed3 state copy", [&] {
+            auto copy = fixed_node;
+            do_not_optimize(copy.number_of_all_clauses);
+        });
+        run_benchmark("fixed3 state undo (assignment)", [&] { fixed_scratch = fixed_true_child; }, [&] {
+            fixed_scratch = fixed_node;
+        });
+    }
+
+    auto bit_root = BitSATclass(variables_number, formula, number_of_clauses, literal_wieghts, literal_count);
+    auto bit_node = bit_root;
+    for(auto decision: trail) {
+        if(node.variables[decision.first].value != -1 && bit_node.variables[decision.first].value == -1) {
+            bit_node.propagation(decision.first, node.variables[decision.first].value);
+        }
+    }
+    bit_node.decision_level = node.decision_level;
+    auto bit_scratch = bit_node;
+    run_benchmark("bit propagation (single literal)", [&] { bit_scratch = bit_node; }, [&] {
+        do_not_optimize(bit_scratch.propagation(variable, 1));
+    });
+    run_benchmark("bit preselect_propz", [&] {
+        do_not_optimize(bit_node.preselect_propz().size());
+    });
+    run_benchmark("bit state copy", [&] {
+        auto copy = bit_node;
+        do_not_optimize(copy.number_of_all_clauses);
+    });
+
+    return 0;
+}
@@ -0,0 +1,424 @@
+#ifndef BIT_SAT_CLASS_H
+#define BIT_SAT_CLASS_H
+
+#include "includes.h"
+#include <cstdint>
+
+/*
+    Search state for small formulas kept in bit vectors:
+        clause_bits   for every clause, the set of its literals (bit literal_index(l))
+        occurrences   for every literal, the set of clauses it appears in
+        true_literals / false_literals   the assignment, as sets of literals
+        satisfied     the set of satisfied clauses
+    Propagation and clause checks are word-wide AND / OR / popcount over
+    these sets, the loops are plain enough for the compiler to vectorize.
+    The members used by the look-ahead and the heuristics mirror SATclass,
+    so solver.h runs unchanged on both.
+*/
+
+using Word = uint64_t;
+const int WORD_BITS = 64;
+
+int words_for(int bits) {
+    return (bits + WORD_BITS - 1)/WORD_BITS;
+}
+
+bool test_bit(const Word* bits, int index) {
+    return (bits[index/WORD_BITS] >> (index % WORD_BITS)) & 1;
+}
+
+void set_bit(Word* bits, int index) {
+    bits[index/WORD_BITS] |= Word(1) << (index % WORD_BITS);
+}
+
+// literal with the given literal_index
+int index_literal(int index) {
+    return index % 2 == 0 ? index/2 + 1 : -(index/2 + 1);
+}
+
+template<typename T>
+class LiteralArray {
+public:
+    std::vector<T> values; // by literal_index
+
+    T& operator[](int literal) {
+        return values[literal_index(literal)];
+    }
+};
+
+struct BitVariable {
+    short value; // -1 for unsigned
+};
+
+class BitSATclass {
+public:
+    std::vector<BitVariable> variables;
+    LiteralArray<double> literal_weights;
+    LiteralArray<int> literal_count;
+    std::vector<int> reducted_clauses; //reducted clauses after propagation
+    std::vector<int> new_binary_clauses;
+    std::vector<int> implicated_variables;
+    int number_of_all_clauses;
+    int decision_level;
+    double trigger;
+    double start_tigger;
+
+    BitSATclass(int number_of_variables, std::unordered_map<int, std::unordered_set<int>>& formula, int number_of_clauses,
+                std::unordered_map<int, double>& literal_weights, std::unordered_map<int, int>& literal_count) :
+            number_of_all_clauses(0), decision_level(0), number_of_variables(number_of_variables),
+            literal_words(words_for(2*number_of_variables)), clause_words(words_for(std::max(number_of_clauses, 1))),
+            number_of_satisfied_clauses(0) {
+        variables = std::vector<BitVariable>(number_of_variables + 1, {-1});
+        this->literal_weights.values = std::vector<double>(2*number_of_variables);
+        this->literal_count.values = std::vector<int>(2*number_of_variables);
+        for(int i=0; i<2*number_of_variables; i++) {
+            this->literal_weights.values[i] = literal_weights[index_literal(i)];
+            this->literal_count.values[i] = literal_count[index_literal(i)];
+        }
+        true_literals = std::vector<Word>(literal_words, 0);
+        false_literals = std::vector<Word>(literal_words, 0);
+        occurrences = std::vector<Word>(2*number_of_variables*clause_words, 0);
+        satisfied = std::vector<Word>(clause_words, 0);
+        touched = std::vector<Word>(clause_words, 0);
+        for(int i=0; i<number_of_clauses; i++) {
+            add_clause(formula[i]);
+        }
+    }
+
+    std::vector<int> preselect_propz() {
+        auto unsigned_variables = get_unsigned_variables();
+        if(decision_level < 5 || unsigned_variables.size() <= 10) {
+            return unsigned_variables;
+        }
+
+        auto binary_count = count_binary_occurrences();
+        auto result = std::vector<int>();
+        auto selected = std::vector<bool>(number_of_variables + 1, false);
+        for(auto var: unsigned_variables) {
+            if(binary_count[var] > 0 && binary_count[-1*var] > 0) {
+                result.push_back(var);
+                selected[var] = true;
+            }
+        }
+        for(auto it = unsigned_variables.begin(); result.size() < 10 && it != unsigned_variables.end(); it++) {
+            if(!selected[*it]) {
+                result.push_back(*it);
+            }
+        }
+        return result;
+    }
+
+    std::vector<int> preselect_cra() {
+        auto unsigned_variables = get_unsigned_variables();
+        if(unsigned_variables.size() < 20) {
+            return unsigned_variables;
+        }
+
+        auto binary_count = count_binary_occurrences();
+        auto sum = LiteralArray<long long>{std::vector<long long>(2*number_of_variables, 0)};
+        for_each_binary_clause([&](int first_literal, int second_literal) {
+            sum[first_literal] += literal_count[-1*second_literal] - binary_count[-1*second_literal];
+            sum[second_literal] += literal_count[-1*first_literal] - binary_count[-1*first_literal];
+        });
+
+        int unsigned_varialbes_count = unsigned_variables.size();
+        auto size = std::max(20, unsigned_varialbes_count/10);
+        std::partial_sort(unsigned_variables.begin(), unsigned_variables.begin() + size, unsigned_variables.end(),
+                          [&sum](int l, int r) { return sum[l]*sum[-1*l] > sum[r]*sum[-1*r]; });
+        unsigned_variables.resize(size);
+        return unsigned_variables;
+    }
+
+    bool is_satisfied() {
+        return number_of_satisfied_clauses == number_of_all_clauses;
+    }
+
+    int get_clause_size(int clause_hash) {
+        if(!contains_clause(clause_hash)) {
+            return 0;
+        }
+        const Word* clause = clause_pointer(clause_hash);
+        int size = 0;
+        for(int i=0; i<literal_words; i++) {
+            size += __builtin_popcountll(clause[i] & ~false_literals[i]);
+        }
+        return size;
+    }
+
+    bool contains_clause(int clause_hash) {
+        return !test_bit(satisfied.data(), clause_hash);
+    }
+
+    std::vector<int> clause_literals(int clause_hash) {
+        auto result = std::vector<int>();
+        if(contains_clause(clause_hash)) {
+            const Word* clause = clause_pointer(clause_hash);
+            for(int i=0; i<literal_words; i++) {
+                for_each_bit(clause[i] & ~false_literals[i], i, [&result](int index) {
+                    result.push_back(index_literal(index));
+                });
+            }
+        }
+        return result;
+    }
+
+    /*
+        Collects the remaining binary clauses, returns true if there are no longer
+        ones left. With stop_at_long_clause the scan ends at the first longer clause.
+    */
+    bool residual_binary_clauses(std::vector<std::pair<int, int>>& clauses, bool stop_at_long_clause) {
+        bool only_binary = true;
+        for(int i=0; i<clause_words; i++) {
+            Word active = ~satisfied[i];
+            while(active) {
+                int clause_hash = i*WORD_BITS + __builtin_ctzll(active);
+                active &= active - 1;
+                if(clause_hash >= number_of_all_clauses) {
+                    return only_binary;
+                }
+                int size = get_clause_size(clause_hash);
+                if(size > 2) {
+                    only_binary = false;
+                    if(stop_at_long_clause) {
+                        return false;
+                    }
+                } else {
+                    auto literals = clause_literals(clause_hash);
+                    clauses.push_back(std::make_pair(literals.front(), literals.back()));
+                }
+            }
+        }
+        return only_binary;
+    }
+
+    void add_learned_binary(int literal, int next_literal) {
+        add_clause({literal, next_literal});
+        // counts stay exact, autarky reasoning relies on them
+        #if DIRECTION_HEURISTIC == 0 || AUTARKY_REASONING == 1
+        literal_count[literal] += 1;
+        literal_count[next_literal] += 1;
+        #endif
+        #if DIFF_HEURISTIC >= 1
+        literal_weights[literal] += powers[2];
+        literal_weights[next_literal] += powers[2];
+        #endif
+    }
+
+    bool propagation(int variable, bool value) {
+        auto assigned_variables = std::vector<int>(); // literals set to true, not processed yet
+        reducted_clauses.clear();
+        new_binary_clauses.clear();
+        #if LOCAL_LEARNING == 1
+            implicated_variables.clear();
+        #endif
+        std::fill(touched.begin(), touched.end(), 0);
+
+        assign(value ? variable : -1*variable);
+        assigned_variables.push_back(value ? variable : -1*variable);
+        bool conflict = false;
+        while(!assigned_variables.empty() && !conflict) {
+            int true_literal = assigned_variables.back();
+            assigned_variables.pop_back();
+
+            const Word* true_occurrences = occurrences_pointer(true_literal);
+            for(int i=0; i<clause_words; i++) {
+                for_each_bit(true_occurrences[i] & ~satisfied[i], i, [this](int clause_hash) {
+                    prepare_satisfied_clause(clause_hash);
+                });
+            }
+
+            int false_literal = -1*true_literal;
+            const Word* false_occurrences = occurrences_pointer(false_literal);
+            for(int i=0; i<clause_words && !conflict; i++) {
+                Word reduced = false_occurrences[i] & ~satisfied[i];
+                Word already_touched = touched[i];
+                touched[i] |= reduced;
+                for_each_bit(reduced, i, [&](int clause_hash) {
+                    if(conflict) {
+                        return;
+                    }
+                    #if DIRECTION_HEURISTIC == 0 || AUTARKY_REASONING == 1
+                    literal_count[false_literal] -= 1;
+                    #endif
+                    int unit_literal = 0;
+                    if(!check_reducted_clause(clause_hash, unit_literal)) {
+                        conflict = true;
+                    } else if(unit_literal != 0) {
+                        assign(unit_literal);
+                        assigned_variables.push_back(unit_literal);
+                        #if LOCAL_LEARNING == 1
+                            if((already_touched >> (clause_hash % WORD_BITS)) & 1) { // reduced earlier in this propagation
+                                implicated_variables.push_back(abs(unit_literal));
+                            }
+                        #endif
+                    }
+                });
+            }
+        }
+        if(conflict) {
+            return false;
+        }
+
+        for(int i=0; i<clause_words; i++) {
+            for_each_bit(touched[i] & ~satisfied[i], i, [this](int clause_hash) {
+                reducted_clauses.push_back(clause_hash);
+                if(get_clause_size(clause_hash) == 2) {
+                    new_binary_clauses.push_back(clause_hash);
+                }
+            });
+        }
+        return true;
+    }
+
+private:
+    int number_of_variables;
+    int literal_words; // words of a set of literals
+    int clause_words; // words of a set of clauses
+    int number_of_satisfied_clauses;
+    std::vector<Word> clause_bits; // literal_words per clause
+    std::vector<Word> occurrences; // clause_words per literal
+    std::vector<Word> true_literals;
+    std::vector<Word> false_literals;
+    std::vector<Word> satisfied;
+    std::vector<Word> touched; // clauses reducted during the current propagation
+
+    template<typename F>
+    static void for_each_bit(Word word, int word_index, F f) {
+        while(word) {
+            f(word_index*WORD_BITS + __builtin_ctzll(word));
+            word &= word - 1;
+        }
+    }
+
+    const Word* clause_pointer(int clause_hash) const {
+        return clause_bits.data() + clause_hash*literal_words;
+    }
+
+    const Word* occurrences_pointer(int literal) const {
+        return occurrences.data() + literal_index(literal)*clause_words;
+    }
+
+    std::vector<int> get_unsigned_variables() {
+        auto result = std::vector<int>();
+        for(int i=0; i<literal_words; i++) {
+            Word assigned = true_literals[i] | false_literals[i];
+            assigned |= (assigned >> 1) & 0x5555555555555555ULL; // both literals of a variable share a pair of bits
+            for_each_bit(~assigned & 0x5555555555555555ULL, i, [&](int index) {
+                if(index < 2*number_of_variables) {
+                    result.push_back(index/2 + 1);
+                }
+            });
+        }
+        return result;
+    }
+
+    template<typename F>
+    void for_each_binary_clause(F f) {
+        for(int i=0; i<clause_words; i++) {
+            for_each_bit(~satisfied[i], i, [&](int clause_hash) {
+                if(clause_hash < number_of_all_clauses && get_clause_size(clause_hash) == 2) {
+                    auto literals = clause_literals(clause_hash);
+                    f(literals[0], literals[1]);
+                }
+            });
+        }
+    }
+
+    LiteralArray<int> count_binary_occurrences() {
+        auto binary_count = LiteralArray<int>{std::vector<int>(2*number_of_variables, 0)};
+        for_each_binary_clause([&binary_count](int first_literal, int second_literal) {
+            binary_count[first_literal] += 1;
+            binary_count[second_literal] += 1;
+        });
+        return binary_count;
+    }
+
+    void assign(int literal) {
+        variables[abs(literal)].value = literal > 0;
+        set_bit(true_literals.data(), literal_index(literal));
+        set_bit(false_literals.data(), literal_index(-1*literal));
+    }
+
+    void prepare_satisfied_clause(int clause_hash) {
+        #if DIFF_HEURISTIC >= 1
+        double coeff = clause_power(get_clause_size(clause_hash));
+        #endif
+        #if DIRECTION_HEURISTIC == 0 || AUTARKY_REASONING == 1 || DIFF_HEURISTIC >= 1
+        const Word* clause = clause_pointer(clause_hash);
+        for(int i=0; i<literal_words; i++) {
+            for_each_bit(clause[i] & ~false_literals[i], i, [&](int index) {
+                #if DIRECTION_HEURISTIC == 0 || AUTARKY_REASONING == 1
+                literal_count.values[index] -= 1;
+                #endif
+                #if DIFF_HEURISTIC >= 1
+                literal_weights.values[index] -= coeff;
+                #endif
+            });
+        }
+        #endif
+        set_bit(satisfied.data(), clause_hash);
+        number_of_satisfied_clauses += 1;
+    }
+
+    /*
+        Returns false if the clause has no literal left that is not false.
+        unit_literal is set if exactly one unassigned literal is left.
+    */
+    bool check_reducted_clause(int clause_hash, int& unit_literal) {
+        const Word* clause = clause_pointer(clause_hash);
+        int left = 0;
+        int last_word = 0;
+        for(int i=0; i<literal_words; i++) {
+            if(clause[i] & true_literals[i]) {
+                return true; // satisfied by a literal waiting in the queue
+            }
+            Word not_false = clause[i] & ~false_literals[i];
+            if(not_false) {
+                left += __builtin_popcountll(not_false);
+                last_word = i;
+            }
+        }
+        if(left == 0) {
+            return false;
+        }
+        if(left == 1) {
+            Word not_false = clause[last_word] & ~false_literals[last_word];
+            unit_literal = index_literal(last_word*WORD_BITS + __builtin_ctzll(not_false));
+        }
+        return true;
+    }
+
+    void grow_clause_capacity() {
+        int new_clause_words = 2*clause_words;
+        auto new_occurrences = std::vector<Word>(2*number_of_variables*new_clause_words, 0);
+        for(int i=0; i<2*number_of_variables; i++) {
+            std::copy(occurrences.begin() + i*clause_words, occurrences.begin() + (i + 1)*clause_words,
+                      new_occurrences.begin() + i*new_clause_words);
+        }
+        occurrences = std::move(new_occurrences);
+        satisfied.resize(new_clause_words, 0);
+        touched.resize(new_clause_words, 0);
+        clause_words = new_clause_words;
+    }
+
+    template<typename Clause>
+    void add_clause(const Clause& literals) {
+        if(number_of_all_clauses == clause_words*WORD_BITS) {
+            grow_clause_capacity();
+        }
+        int clause_hash = number_of_all_clauses;
+        clause_bits.resize(clause_bits.size() + literal_words, 0);
+        Word* clause = clause_bits.data() + clause_hash*literal_words;
+        for(auto literal: literals) {
+            set_bit(clause, literal_index(literal));
+            set_bit(occurrences.data() + literal_index(literal)*clause_words, clause_hash);
+        }
+        number_of_all_clauses += 1;
+    }
+
+    void add_clause(std::initializer_list<int> literals) {
+        add_clause<std::initializer_list<int>>(literals);
+    }
+};
+
+#endif
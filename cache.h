@@ -0,0 +1,279 @@
+#ifndef CACHE_H
+#define CACHE_H
+
+#include "includes.h"
+#include <fstream>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+/*
+    Binary pre-parse cache, written after the first parse of a CNF and read
+    back on later runs instead of parsing the text again. The whole file is
+    read and copied into the solver's maps, so loading still takes time
+    proportional to the formula. Layout (native endianness, every section
+    aligned to 8 bytes):
+        CacheHeader
+        double  literal_weights[2n]
+        int32   literal_count[2n]
+        uint32  clause_offsets[m + 1],          int32 clause_literals[]
+        uint32  occurrence_offsets[n + 1],      int32 occurrences[] (clauses of variable v, without binaries)
+        uint32  binary_offsets[2n + 1],         int32 binaries[] (pairs: other literal, clause)
+    Literal l is stored at index 2(l-1) if positive and 2(-l-1)+1 if negative.
+*/
+
+const char CACHE_MAGIC[4] = {'A', 'L', 'B', 'F'};
+const uint32_t CACHE_VERSION = 3; // 2: literal_weights from the constexpr powers table, 3: no max_clause_size
+
+struct CacheHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t diff_heuristic; // literal_weights depend on it
+    uint32_t number_of_variables;
+    uint32_t number_of_clauses;
+    uint64_t source_size;
+    uint64_t source_hash;
+    uint64_t clause_literals_size;
+    uint64_t occurrences_size;
+    uint64_t binaries_size;
+};
+
+uint64_t source_checksum(const std::string& source) {
+    uint64_t hash = 14695981039346656037ULL; // FNV-1a
+    for(unsigned char c: source) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+size_t aligned_section(size_t bytes) {
+    return (bytes + 7) & ~static_cast<size_t>(7);
+}
+
+template<typename T>
+void write_section(std::ofstream& out, const std::vector<T>& data) {
+    size_t bytes = data.size()*sizeof(T);
+    out.write(reinterpret_cast<const char*>(data.data()), bytes);
+    static const char padding[8] = {};
+    out.write(padding, aligned_section(bytes) - bytes);
+}
+
+template<typename T>
+const T* read_section(const char*& position, uint64_t count) {
+    auto section = reinterpret_cast<const T*>(position);
+    position += aligned_section(count*sizeof(T));
+    return section;
+}
+
+bool write_formula_cache(const std::string& path, uint64_t source_size, uint64_t source_hash, int number_of_variables,
+                         int number_of_clauses, std::unordered_map<int, std::unordered_set<int>>& formula,
+                         std::unordered_map<int, Variable>& variables, std::unordered_map<int, PairsSet>& binary_clauses,
+                         std::unordered_map<int, double>& literal_weights, std::unordered_map<int, int>& literal_count) {
+    auto weights = std::vector<double>(2*number_of_variables);
+    auto counts = std::vector<int32_t>(2*number_of_variables);
+    auto binary_offsets = std::vector<uint32_t>(1, 0);
+    auto binaries = std::vector<int32_t>();
+    for(int i=0; i<2*number_of_variables; i++) {
+        int literal = i % 2 == 0 ? i/2 + 1 : -(i/2 + 1);
+        weights[i] = literal_weights[literal];
+        counts[i] = literal_count[literal];
+        for(auto binary: binary_clauses[literal]) {
+            binaries.push_back(binary.first);
+            binaries.push_back(binary.second);
+        }
+        binary_offsets.push_back(binaries.size());
+    }
+
+    auto clause_offsets = std::vector<uint32_t>(1, 0);
+    auto clause_literals = std::vector<int32_t>();
+    for(int i=0; i<number_of_clauses; i++) {
+        auto& clause = formula[i];
+        clause_literals.insert(clause_literals.end(), clause.begin(), clause.end());
+        clause_offsets.push_back(clause_literals.size());
+    }
+
+    auto occurrence_offsets = std::vector<uint32_t>(1, 0);
+    auto occurrences = std::vector<int32_t>();
+    for(int i=1; i<=number_of_variables; i++) {
+        auto& clauses = variables[i].clauses;
+        occurrences.insert(occurrences.end(), clauses.begin(), clauses.end());
+        occurrence_offsets.push_back(occurrences.size());
+    }
+
+    CacheHeader header = {};
+    std::memcpy(header.magic, CACHE_MAGIC, 4);
+    header.version = CACHE_VERSION;
+    header.diff_heuristic = DIFF_HEURISTIC;
+    header.number_of_variables = number_of_variables;
+    header.number_of_clauses = number_of_clauses;
+    header.source_size = source_size;
+    header.source_hash = source_hash;
+    header.clause_literals_size = clause_literals.size();
+    header.occurrences_size = occurrences.size();
+    header.binaries_size = binaries.size();
+
+    std::string temporary_path = path + ".tmp";
+    std::ofstream out(temporary_path, std::ios::binary | std::ios::trunc);
+    if(!out) {
+        return false;
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    write_section(out, weights);
+    write_section(out, counts);
+    write_section(out, clause_offsets);
+    write_section(out, clause_literals);
+    write_section(out, occurrence_offsets);
+    write_section(out, occurrences);
+    write_section(out, binary_offsets);
+    write_section(out, binaries);
+    out.close();
+    if(!out) {
+        return false;
+    }
+    return std::rename(temporary_path.c_str(), path.c_str()) == 0;
+}
+
+// offsets must start at 0, never decrease and end at the size of the section they index
+bool valid_offsets(const uint32_t* offsets, uint64_t count, uint64_t section_size) {
+    if(offsets[0] != 0 || offsets[count - 1] != section_size) {
+        return false;
+    }
+    for(uint64_t i=1; i<count; i++) {
+        if(offsets[i] < offsets[i - 1]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool valid_literals(const int32_t* literals, uint64_t count, uint64_t stride, uint64_t number_of_variables) {
+    for(uint64_t i=0; i<count; i+=stride) {
+        if(literals[i] == 0 || static_cast<uint64_t>(std::abs(static_cast<int64_t>(literals[i]))) > number_of_variables) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool valid_clause_hashes(const int32_t* clauses, uint64_t count, uint64_t stride, uint64_t number_of_clauses) {
+    for(uint64_t i=0; i<count; i+=stride) {
+        if(clauses[i] < 0 || static_cast<uint64_t>(clauses[i]) >= number_of_clauses) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+    Returns false if the cache is missing, truncated, inconsistent, written
+    by another version or settings, or does not belong to the given source.
+*/
+bool load_formula_cache(const std::string& path, uint64_t source_size, uint64_t source_hash,
+                        std::unordered_map<int, std::unordered_set<int>>& formula, std::unordered_map<int, Variable>& variables,
+                        std::unordered_set<int>& unsigned_variables, std::unordered_map<int, PairsSet>& binary_clauses,
+                        int& number_of_clauses, std::unordered_map<int, double>& literal_weights,
+                        std::unordered_map<int, int>& literal_count) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if(!in) {
+        return false;
+    }
+    size_t file_size = in.tellg();
+    if(file_size < sizeof(CacheHeader)) {
+        return false;
+    }
+    auto buffer = std::vector<uint64_t>((file_size + 7)/8); // sections are read in place, 8 byte alignment
+    in.seekg(0);
+    if(!in.read(reinterpret_cast<char*>(buffer.data()), file_size)) {
+        return false;
+    }
+
+    auto base = reinterpret_cast<const char*>(buffer.data());
+    CacheHeader header;
+    std::memcpy(&header, base, sizeof(header));
+    uint64_t n = header.number_of_variables;
+    uint64_t m = header.number_of_clauses;
+    size_t expected_size = sizeof(CacheHeader) + aligned_section(2*n*sizeof(double)) + aligned_section(2*n*sizeof(int32_t))
+                           + aligned_section((m + 1)*sizeof(uint32_t)) + aligned_section(header.clause_literals_size*sizeof(int32_t))
+                           + aligned_section((n + 1)*sizeof(uint32_t)) + aligned_section(header.occurrences_size*sizeof(int32_t))
+                           + aligned_section((2*n + 1)*sizeof(uint32_t)) + aligned_section(header.binaries_size*sizeof(int32_t));
+    if(!std::equal(header.magic, header.magic + 4, CACHE_MAGIC) || header.version != CACHE_VERSION
+       || header.diff_heuristic != DIFF_HEURISTIC || header.source_size != source_size
+       || header.source_hash != source_hash || file_size != expected_size) {
+        return false;
+    }
+
+    const char* position = base + sizeof(CacheHeader);
+    auto weights = read_section<double>(position, 2*n);
+    auto counts = read_section<int32_t>(position, 2*n);
+    auto clause_offsets = read_section<uint32_t>(position, m + 1);
+    auto clause_literals = read_section<int32_t>(position, header.clause_literals_size);
+    auto occurrence_offsets = read_section<uint32_t>(position, n + 1);
+    auto occurrences = read_section<int32_t>(position, header.occurrences_size);
+    auto binary_offsets = read_section<uint32_t>(position, 2*n + 1);
+    auto binaries = read_section<int32_t>(position, header.binaries_size);
+
+    bool binary_pairs = header.binaries_size % 2 == 0;
+    for(uint64_t i=0; i<=2*n && binary_pairs; i++) {
+        binary_pairs = binary_offsets[i] % 2 == 0;
+    }
+    if(!valid_offsets(clause_offsets, m + 1, header.clause_literals_size)
+       || !valid_offsets(occurrence_offsets, n + 1, header.occurrences_size)
+       || !valid_offsets(binary_offsets, 2*n + 1, header.binaries_size) || !binary_pairs
+       || !valid_literals(clause_literals, header.clause_literals_size, 1, n)
+       || !valid_clause_hashes(occurrences, header.occurrences_size, 1, m)
+       || !valid_literals(binaries, header.binaries_size, 2, n)
+       || !valid_clause_hashes(binaries + 1, header.binaries_size, 2, m)) {
+        return false;
+    }
+
+    number_of_clauses = m;
+    for(uint64_t i=0; i<m; i++) {
+        formula[i] = std::unordered_set<int>(clause_literals + clause_offsets[i], clause_literals + clause_offsets[i + 1]);
+    }
+    for(uint64_t i=1; i<=n; i++) {
+        variables[i] = {-1, -1, std::unordered_set<int>(occurrences + occurrence_offsets[i - 1], occurrences + occurrence_offsets[i])};
+        unsigned_variables.insert(i);
+    }
+    for(uint64_t i=0; i<2*n; i++) {
+        int literal = i % 2 == 0 ? i/2 + 1 : -(i/2 + 1);
+        literal_weights[literal] = weights[i];
+        literal_count[literal] = counts[i];
+        auto& clauses = binary_clauses[literal];
+        for(uint32_t j=binary_offsets[i]; j<binary_offsets[i + 1]; j+=2) {
+            clauses.insert(std::make_pair(binaries[j], binaries[j + 1]));
+        }
+    }
+    return true;
+}
+
+/*
+    Reads the CNF from standard input like read_input, but uses the cache at
+    path if it belongs to the same input and rebuilds the cache otherwise.
+*/
+void read_input_cached(const std::string& path, std::unordered_map<int, std::unordered_set<int>>& formula,
+                       std::unordered_map<int, Variable>& variables, std::unordered_set<int>& unsigned_variables,
+                       std::unordered_map<int, PairsSet>& binary_clauses, int& number_of_clauses,
+                       std::unordered_map<int, double>& literal_weights, std::unordered_map<int, int>& literal_count) {
+    std::ostringstream buffer;
+    buffer << std::cin.rdbuf();
+    std::string source = buffer.str();
+    uint64_t source_hash = source_checksum(source);
+
+    if(load_formula_cache(path, source.size(), source_hash, formula, variables, unsigned_variables, binary_clauses,
+                          number_of_clauses, literal_weights, literal_count)) {
+        return;
+    }
+
+    std::istringstream in(source);
+    auto standard_input = std::cin.rdbuf(in.rdbuf());
+    read_input(formula, variables, unsigned_variables, binary_clauses, number_of_clauses, literal_weights, literal_count);
+    std::cin.rdbuf(standard_input);
+
+    if(!write_formula_cache(path, source.size(), source_hash, variables.size(), number_of_clauses, formula, variables,
+                            binary_clauses, literal_weights, literal_count)) {
+        std::cerr << "could not write formula cache " << path << '\n';
+    }
+}
+
+#endif
@@ -0,0 +1,179 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "includes.h"
+#include <fstream>
+#include <cstdint>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+/*
+    Checkpoint file layout (little endian, as written by the machine):
+        char[4]   magic "ALBC"
+        uint32    version
+        uint64    fingerprint of the input formula
+        uint8     march_true_is_better
+        double    trigger of the frontier node
+        uint32    number of decisions
+        decisions: int32 variable, uint8 flags (bit 0: value, bit 1: second branch)
+
+    The search state is stored as the path of decisions from the root to the
+    frontier node. Everything on the left of that path was already refuted,
+    so resuming replays the path (one look-ahead per level) and continues
+    from there.
+*/
+
+const char CHECKPOINT_MAGIC[4] = {'A', 'L', 'B', 'C'};
+const uint32_t CHECKPOINT_VERSION = 1;
+
+struct Decision {
+    int variable;
+    bool value; // value of the first branch
+    bool second_branch; // first branch already refuted, !value is searched
+};
+
+struct Checkpoint {
+    uint64_t fingerprint;
+    bool march_true_is_better;
+    double trigger;
+    std::vector<Decision> path;
+};
+
+uint64_t formula_fingerprint(std::unordered_map<int, std::unordered_set<int>>& formula, int number_of_clauses) {
+    uint64_t hash = 14695981039346656037ULL; // FNV-1a
+    auto mix = [&hash](int value) {
+        for(int i=0; i<4; i++) {
+            hash ^= (value >> (8*i)) & 0xff;
+            hash *= 1099511628211ULL;
+        }
+    };
+    for(int i=0; i<number_of_clauses; i++) {
+        auto clause = std::vector<int>(formula[i].begin(), formula[i].end());
+        std::sort(clause.begin(), clause.end());
+        for(auto literal: clause) {
+            mix(literal);
+        }
+        mix(0);
+    }
+    return hash;
+}
+
+bool write_checkpoint(const std::string& path, const Checkpoint& checkpoint) {
+    // write to a temporary file first so a preemption never leaves a torn checkpoint
+    std::string temporary_path = path + ".tmp";
+    std::ofstream out(temporary_path, std::ios::binary | std::ios::trunc);
+    if(!out) {
+        return false;
+    }
+    uint8_t march = checkpoint.march_true_is_better;
+    uint32_t size = checkpoint.path.size();
+    out.write(CHECKPOINT_MAGIC, 4);
+    out.write(reinterpret_cast<const char*>(&CHECKPOINT_VERSION), sizeof(CHECKPOINT_VERSION));
+    out.write(reinterpret_cast<const char*>(&checkpoint.fingerprint), sizeof(checkpoint.fingerprint));
+    out.write(reinterpret_cast<const char*>(&march), sizeof(march));
+    out.write(reinterpret_cast<const char*>(&checkpoint.trigger), sizeof(checkpoint.trigger));
+    out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    for(auto& decision: checkpoint.path) {
+        int32_t variable = decision.variable;
+        uint8_t flags = (decision.value ? 1 : 0) | (decision.second_branch ? 2 : 0);
+        out.write(reinterpret_cast<const char*>(&variable), sizeof(variable));
+        out.write(reinterpret_cast<const char*>(&flags), sizeof(flags));
+    }
+    out.close();
+    if(!out) {
+        return false;
+    }
+    return std::rename(temporary_path.c_str(), path.c_str()) == 0;
+}
+
+bool read_checkpoint(const std::string& path, Checkpoint& checkpoint) {
+    std::ifstream in(path, std::ios::binary);
+    if(!in) {
+        return false;
+    }
+    char magic[4];
+    uint32_t version = 0;
+    uint8_t march = 0;
+    uint32_t size = 0;
+    in.read(magic, 4);
+    in.read(reinterpret_cast<char*>(&version), sizeof(version));
+    if(!in || !std::equal(magic, magic + 4, CHECKPOINT_MAGIC) || version != CHECKPOINT_VERSION) {
+        return false;
+    }
+    in.read(reinterpret_cast<char*>(&checkpoint.fingerprint), sizeof(checkpoint.fingerprint));
+    in.read(reinterpret_cast<char*>(&march), sizeof(march));
+    in.read(reinterpret_cast<char*>(&checkpoint.trigger), sizeof(checkpoint.trigger));
+    in.read(reinterpret_cast<char*>(&size), sizeof(size));
+    checkpoint.march_true_is_better = march;
+    checkpoint.path.clear();
+    for(uint32_t i=0; i<size && in; i++) {
+        int32_t variable;
+        uint8_t flags;
+        in.read(reinterpret_cast<char*>(&variable), sizeof(variable));
+        in.read(reinterpret_cast<char*>(&flags), sizeof(flags));
+        checkpoint.path.push_back({variable, (flags & 1) != 0, (flags & 2) != 0});
+    }
+    return static_cast<bool>(in);
+}
+
+/*
+    Writes checkpoints on a background thread. The search only hands over
+    a copy of the decision path; if the writer is still busy, the pending
+    checkpoint is replaced by the newer one.
+*/
+class CheckpointWriter {
+public:
+    CheckpointWriter(const std::string& path) : path(path), has_pending(false), stopped(false) {
+        worker = std::thread(&CheckpointWriter::run, this);
+    }
+
+    ~CheckpointWriter() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopped = true;
+        }
+        condition.notify_one();
+        worker.join();
+    }
+
+    void submit(Checkpoint checkpoint) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pending = std::move(checkpoint);
+            has_pending = true;
+        }
+        condition.notify_one();
+    }
+
+private:
+    std::string path;
+    Checkpoint pending;
+    bool has_pending;
+    bool stopped;
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::thread worker;
+
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while(true) {
+            condition.wait(lock, [this] { return has_pending || stopped; });
+            if(has_pending) {
+                Checkpoint checkpoint = std::move(pending);
+                has_pending = false;
+                lock.unlock();
+                if(!write_checkpoint(path, checkpoint)) {
+                    std::cerr << "could not write checkpoint " << path << '\n';
+                }
+                lock.lock();
+            } else if(stopped) {
+                return;
+            }
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,95 @@
+#ifndef FIXED_CLAUSE_H
+#define FIXED_CLAUSE_H
+
+#include "includes.h"
+#include <array>
+#include <initializer_list>
+
+/*
+    Clause of at most K literals kept inline, used by SATclass instead of
+    std::unordered_set<int> when no clause of the formula is longer than K.
+    Offers the part of the set interface the solver uses. erase moves the
+    last literal into the gap, so the order of literals is not stable.
+*/
+template<int K>
+class FixedClause {
+public:
+    static const int width = K;
+
+    FixedClause() : count(0) {}
+
+    FixedClause(std::initializer_list<int> initial) : count(0) {
+        for(auto literal: initial) {
+            insert(literal);
+        }
+    }
+
+    template<typename Iterator>
+    FixedClause(Iterator first, Iterator last) : count(0) {
+        for(; first != last; first++) {
+            insert(*first);
+        }
+    }
+
+    int size() const {
+        return count;
+    }
+
+    bool empty() const {
+        return count == 0;
+    }
+
+    int operator[](int position) const {
+        return literals[position];
+    }
+
+    int* begin() {
+        return literals.data();
+    }
+
+    int* end() {
+        return literals.data() + count;
+    }
+
+    const int* begin() const {
+        return literals.data();
+    }
+
+    const int* end() const {
+        return literals.data() + count;
+    }
+
+    int* find(int literal) {
+        for(int i=0; i<K; i++) {
+            if(i < count && literals[i] == literal) {
+                return literals.data() + i;
+            }
+        }
+        return end();
+    }
+
+    const int* find(int literal) const {
+        return const_cast<FixedClause*>(this)->find(literal);
+    }
+
+    void insert(int literal) {
+        if(find(literal) == end()) {
+            literals[count++] = literal;
+        }
+    }
+
+    size_t erase(int literal) {
+        int* position = find(literal);
+        if(position == end()) {
+            return 0;
+        }
+        *position = literals[--count];
+        return 1;
+    }
+
+private:
+    std::array<int, K> literals;
+    int count;
+};
+
+#endif
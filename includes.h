@@ -12,6 +12,8 @@
 #include <ctime>
 #include <iterator>
 #include <algorithm>
+#include <atomic>
+#include <future>
 
 using PairsSet = std::unordered_set<std::pair<int, int>, boost::hash< std::pair<int, int> > >;
 
@@ -0,0 +1,232 @@
+#ifndef LOCAL_SEARCH_H
+#define LOCAL_SEARCH_H
+
+#include "includes.h"
+#include <cmath>
+#include <mutex>
+#include <random>
+
+/*
+    Best assignment found by the local search so far, read by the direction
+    heuristic of the systematic search (LOCAL_SEARCH == 2).
+*/
+class SharedPhases {
+public:
+    void publish(const std::vector<bool>& new_phases, int number_of_unsatisfied) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if(phases.empty() || number_of_unsatisfied < best_unsatisfied) {
+            phases = new_phases;
+            best_unsatisfied = number_of_unsatisfied;
+        }
+    }
+
+    bool get(int variable, bool& value) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if(phases.empty()) {
+            return false;
+        }
+        value = phases[variable];
+        return true;
+    }
+
+private:
+    std::mutex mutex;
+    std::vector<bool> phases; // by variable
+    int best_unsatisfied = 0;
+};
+
+SharedPhases local_search_phases;
+
+/*
+    probSAT: picks a random unsatisfied clause and flips one of its variables
+    with probability proportional to (eps + break)^-cb, where break is the
+    number of clauses that would become unsatisfied.
+    The formula is kept in flat arrays (clause arena and occurrence lists).
+*/
+class ProbSAT {
+public:
+    std::vector<bool> model; // by variable, valid after solve returned true
+
+    ProbSAT(std::unordered_map<int, std::unordered_set<int>>& formula, int number_of_clauses, int number_of_variables,
+            unsigned seed) : number_of_variables(number_of_variables), number_of_clauses(number_of_clauses), generator(seed) {
+        clause_start = std::vector<int>(1, 0);
+        auto occurrence_count = std::vector<int>(2*number_of_variables + 1, 0);
+        int max_clause_size = 0;
+        for(int i=0; i<number_of_clauses; i++) {
+            for(auto literal: formula[i]) {
+                clause_literals.push_back(literal);
+                occurrence_count[literal_index(literal) + 1] += 1;
+            }
+            clause_start.push_back(clause_literals.size());
+            max_clause_size = std::max(max_clause_size, (int) formula[i].size());
+        }
+        for(int i=0; i<2*number_of_variables; i++) {
+            occurrence_count[i + 1] += occurrence_count[i];
+        }
+        occurrence_start = occurrence_count;
+        occurrences = std::vector<int>(clause_literals.size());
+        for(int i=0; i<number_of_clauses; i++) {
+            for(int j=clause_start[i]; j<clause_start[i + 1]; j++) {
+                occurrences[occurrence_count[literal_index(clause_literals[j])]++] = i;
+            }
+        }
+
+        // cb values from the probSAT paper for the polynomial break function
+        double cb = max_clause_size <= 3 ? 2.38 : max_clause_size == 4 ? 3.0 : max_clause_size == 5 ? 3.7
+                  : max_clause_size == 6 ? 5.1 : 5.4;
+        for(int i=0; i<BREAK_TABLE_SIZE; i++) {
+            break_probability[i] = std::pow(1.0 + i, -cb);
+        }
+    }
+
+    /*
+        Searches from start_phases, later tries start from random assignments.
+        Stops when stop is set. Returns true with a verified model.
+    */
+    bool solve(const std::vector<bool>& start_phases, const std::atomic<bool>& stop, SharedPhases* shared_phases) {
+        long long max_flips = 2000LL*number_of_variables + 100000;
+        for(int attempt=0; !stop.load(std::memory_order_relaxed); attempt++) {
+            if(attempt == 0) {
+                assignment = start_phases;
+            } else {
+                for(int var=1; var<=number_of_variables; var++) {
+                    assignment[var] = generator() % 2 == 0;
+                }
+            }
+            initialize();
+            auto best = assignment;
+            size_t best_unsatisfied = unsatisfied_clauses.size();
+
+            for(long long flip=0; flip<max_flips && !unsatisfied_clauses.empty(); flip++) {
+                if(flip % 1024 == 0 && stop.load(std::memory_order_relaxed)) {
+                    return false;
+                }
+                flip_variable(pick_variable());
+                if(unsatisfied_clauses.size() < best_unsatisfied) {
+                    best_unsatisfied = unsatisfied_clauses.size();
+                    best = assignment;
+                }
+            }
+
+            if(unsatisfied_clauses.empty() && verify()) {
+                model = assignment;
+                return true;
+            }
+            if(shared_phases != nullptr) {
+                shared_phases->publish(best, best_unsatisfied);
+            }
+        }
+        return false;
+    }
+
+private:
+    static const int BREAK_TABLE_SIZE = 64;
+
+    int number_of_variables;
+    int number_of_clauses;
+    std::mt19937 generator;
+    std::vector<int> clause_start; // clause i is clause_literals[clause_start[i] .. clause_start[i+1])
+    std::vector<int> clause_literals;
+    std::vector<int> occurrence_start; // by literal_index, into occurrences
+    std::vector<int> occurrences;
+    std::vector<bool> assignment; // by variable
+    std::vector<int> true_count; // by clause
+    std::vector<int> unsatisfied_clauses;
+    std::vector<int> unsatisfied_position; // by clause, -1 if satisfied
+    double break_probability[BREAK_TABLE_SIZE];
+
+    bool is_true(int literal) const {
+        return assignment[abs(literal)] == (literal > 0);
+    }
+
+    void add_unsatisfied(int clause) {
+        unsatisfied_position[clause] = unsatisfied_clauses.size();
+        unsatisfied_clauses.push_back(clause);
+    }
+
+    void remove_unsatisfied(int clause) {
+        int last = unsatisfied_clauses.back();
+        unsatisfied_clauses[unsatisfied_position[clause]] = last;
+        unsatisfied_position[last] = unsatisfied_position[clause];
+        unsatisfied_clauses.pop_back();
+        unsatisfied_position[clause] = -1;
+    }
+
+    void initialize() {
+        true_count = std::vector<int>(number_of_clauses, 0);
+        unsatisfied_clauses.clear();
+        unsatisfied_position = std::vector<int>(number_of_clauses, -1);
+        for(int i=0; i<number_of_clauses; i++) {
+            for(int j=clause_start[i]; j<clause_start[i + 1]; j++) {
+                true_count[i] += is_true(clause_literals[j]);
+            }
+            if(true_count[i] == 0) {
+                add_unsatisfied(i);
+            }
+        }
+    }
+
+    int break_value(int variable) const {
+        int true_literal = assignment[variable] ? variable : -1*variable;
+        int index = literal_index(true_literal);
+        int result = 0;
+        for(int j=occurrence_start[index]; j<occurrence_start[index + 1]; j++) {
+            result += true_count[occurrences[j]] == 1;
+        }
+        return result;
+    }
+
+    int pick_variable() {
+        int clause = unsatisfied_clauses[generator() % unsatisfied_clauses.size()];
+        double probabilities[BREAK_TABLE_SIZE];
+        double sum = 0;
+        int size = std::min(clause_start[clause + 1] - clause_start[clause], BREAK_TABLE_SIZE);
+        for(int j=0; j<size; j++) {
+            int breaks = std::min(break_value(abs(clause_literals[clause_start[clause] + j])), BREAK_TABLE_SIZE - 1);
+            probabilities[j] = break_probability[breaks];
+            sum += probabilities[j];
+        }
+        double choice = std::uniform_real_distribution<double>(0, sum)(generator);
+        for(int j=0; j<size - 1; j++) {
+            choice -= probabilities[j];
+            if(choice <= 0) {
+                return abs(clause_literals[clause_start[clause] + j]);
+            }
+        }
+        return abs(clause_literals[clause_start[clause] + size - 1]);
+    }
+
+    void flip_variable(int variable) {
+        int old_true = assignment[variable] ? variable : -1*variable;
+        assignment[variable] = !assignment[variable];
+        int index = literal_index(old_true);
+        for(int j=occurrence_start[index]; j<occurrence_start[index + 1]; j++) {
+            int clause = occurrences[j];
+            if(--true_count[clause] == 0) {
+                add_unsatisfied(clause);
+            }
+        }
+        index = literal_index(-1*old_true);
+        for(int j=occurrence_start[index]; j<occurrence_start[index + 1]; j++) {
+            int clause = occurrences[j];
+            if(true_count[clause]++ == 0) {
+                remove_unsatisfied(clause);
+            }
+        }
+    }
+
+    bool verify() const {
+        for(int i=0; i<number_of_clauses; i++) {
+            bool satisfied = false;
+            for(int j=clause_start[i]; j<clause_start[i + 1] && !satisfied; j++) {
+                satisfied = is_true(clause_literals[j]);
+            }
+            if(!satisfied) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+#endif
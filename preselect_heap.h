@@ -0,0 +1,126 @@
+#ifndef PRESELECT_HEAP_H
+#define PRESELECT_HEAP_H
+
+#include "includes.h"
+#include <queue>
+
+/*
+    Indexed max-heap of variables ordered by their preselection score.
+    Scores are updated in place, so the heap travels with SATclass copies
+    and backtracking restores it together with the rest of the state.
+*/
+class PreselectHeap {
+public:
+    PreselectHeap() {}
+
+    PreselectHeap(int number_of_variables) : position(number_of_variables + 1, -1), score(number_of_variables + 1, 0) {}
+
+    bool contains(int variable) const {
+        return position[variable] != -1;
+    }
+
+    void update(int variable, long long new_score) {
+        if(!contains(variable)) {
+            position[variable] = heap.size();
+            heap.push_back(variable);
+            score[variable] = new_score;
+            sift_up(position[variable]);
+        } else if(new_score > score[variable]) {
+            score[variable] = new_score;
+            sift_up(position[variable]);
+        } else if(new_score < score[variable]) {
+            score[variable] = new_score;
+            sift_down(position[variable]);
+        }
+    }
+
+    void remove(int variable) {
+        if(!contains(variable)) {
+            return;
+        }
+        int index = position[variable];
+        int last = heap.back();
+        heap.pop_back();
+        position[variable] = -1;
+        if(last != variable) {
+            heap[index] = last;
+            position[last] = index;
+            sift_up(index);
+            sift_down(position[last]);
+        }
+    }
+
+    // all variables with score > 0, visits only them and their direct children
+    void collect_positive(std::unordered_set<int>& result) const {
+        auto to_visit = std::vector<int>();
+        if(!heap.empty()) {
+            to_visit.push_back(0);
+        }
+        while(!to_visit.empty()) {
+            int index = to_visit.back();
+            to_visit.pop_back();
+            if(score[heap[index]] <= 0) {
+                continue;
+            }
+            result.insert(heap[index]);
+            for(int child=2*index + 1; child<=2*index + 2 && child<static_cast<int>(heap.size()); child++) {
+                to_visit.push_back(child);
+            }
+        }
+    }
+
+    // count variables with the highest scores in O(count log count)
+    void collect_top(int count, std::unordered_set<int>& result) const {
+        auto by_score = [this](int l, int r) { return score[heap[l]] < score[heap[r]]; };
+        std::priority_queue<int, std::vector<int>, decltype(by_score)> candidates(by_score);
+        if(!heap.empty()) {
+            candidates.push(0);
+        }
+        while(count > 0 && !candidates.empty()) {
+            int index = candidates.top();
+            candidates.pop();
+            result.insert(heap[index]);
+            count--;
+            for(int child=2*index + 1; child<=2*index + 2 && child<static_cast<int>(heap.size()); child++) {
+                candidates.push(child);
+            }
+        }
+    }
+
+private:
+    std::vector<int> heap;
+    std::vector<int> position; // index in heap by variable, -1 if not in heap
+    std::vector<long long> score; // by variable
+
+    void swap_nodes(int i, int j) {
+        std::swap(heap[i], heap[j]);
+        position[heap[i]] = i;
+        position[heap[j]] = j;
+    }
+
+    void sift_up(int index) {
+        while(index > 0 && score[heap[(index - 1)/2]] < score[heap[index]]) {
+            swap_nodes(index, (index - 1)/2);
+            index = (index - 1)/2;
+        }
+    }
+
+    void sift_down(int index) {
+        int size = heap.size();
+        while(true) {
+            int largest = index;
+            for(int child=2*index + 1; child<=2*index + 2 && child<size; child++) {
+                if(score[heap[child]] > score[heap[largest]]) {
+                    largest = child;
+                }
+            }
+            if(largest == index) {
+                return;
+            }
+            swap_nodes(index, largest);
+            index = largest;
+        }
+    }
+};
+
+#endif
@@ -1,7 +1,7 @@
 #ifndef READER_H
 #define READER_H
 
-std::unordered_map<int, double> powers = std::unordered_map<int, double>();
+#include <array>
 
 void read_input(std::unordered_map<int, std::unordered_set<int>>& formula, std::unordered_map<int, Variable>& variables,
                 std::unordered_set<int>& unsigned_variables, std::unordered_map<int, PairsSet>& binary_clauses, int& number_of_clauses,
@@ -26,47 +26,46 @@ void prepare_variables(int number, std::unordered_map<int, Variable>& variables,
     }
 }
 
-void powers_for_crh(int max_size) {
-    powers[1] = 1;
-    powers[2] = 1;
-    powers[4] = 0.05;
-    powers[5] = 0.01;
-    powers[6] = 0.003;
-    for(int i=7; i<=max_size; i++) {
-        powers[i] = 20.4514*pow(0.218673, i);
-    }
-}
+/*
+    Coefficient of a clause by its size for the difference heuristic.
+    Clauses longer than the table use its last entry.
+*/
+const int POWERS_SIZE = 64;
 
-void powers_for_wbh(int max_size) {
-    double value = 125.0;
-    for(int i=0; i<max_size; i++) {
-        powers[i] = value;
-        value /= 5;
+constexpr std::array<double, POWERS_SIZE> powers_table() {
+    std::array<double, POWERS_SIZE> result = {};
+    #if DIFF_HEURISTIC == 0
+    result[1] = 1;
+    result[2] = 1;
+    result[4] = 0.05;
+    result[5] = 0.01;
+    result[6] = 0.003;
+    double value = 20.4514;
+    for(int i=1; i<POWERS_SIZE; i++) {
+        value *= 0.218673;
+        if(i >= 7) {
+            result[i] = value;
+        }
     }
-}
-
-void powers_for_bsh(int max_size) {
-    double value = 8.0;
-    for(int i=0; i<max_size; i++) {
-        powers[i] = value;
-        value /= 2;
+    #else
+    double value = DIFF_HEURISTIC == 1 ? 125.0 : 8.0; // wbh divides by 5, bsh and bsrh by 2
+    for(int i=0; i<POWERS_SIZE; i++) {
+        result[i] = value;
+        value /= DIFF_HEURISTIC == 1 ? 5 : 2;
     }
+    #endif
+    return result;
 }
 
-void fill_power_arrays_for_heustics(int max_size) {
-    #if DIFF_HEURISTIC == 0
-    powers_for_crh(max_size);
-    #elif DIFF_HEURISTIC == 1
-    powers_for_wbh(max_size);
-    #else
-    powers_for_bsh(max_size);
-    #endif
+constexpr std::array<double, POWERS_SIZE> powers = powers_table();
+
+inline double clause_power(int size) {
+    return powers[std::min(size, POWERS_SIZE - 1)];
 }
 
 void count_weights(std::unordered_map<int, std::unordered_set<int>>& formula, std::unordered_map<int, double>& literal_weights) {
     for(auto i: formula) {
-        int size = i.second.size();
-        double coeff = powers[coeff];
+        double coeff = clause_power(i.second.size());
         for(auto literal: i.second) {
             literal_weights[literal] += coeff;
         }
@@ -92,7 +91,6 @@ void read_input(std::unordered_map<int, std::unordered_set<int>>& formula, std::
     int variables_number = std::stoi(*(info.end() - 2));
     number_of_clauses = std::stoi(*(info.end() - 1));
     prepare_variables(variables_number, variables, unsigned_variables, binary_clauses, literal_weights, literal_count);
-    int max_clause_size = 0;
     for(int i=0; i<number_of_clauses; i++) {
         std::string input;
         std::getline(std::cin, input);
@@ -109,10 +107,6 @@ void read_input(std::unordered_map<int, std::unordered_set<int>>& formula, std::
             clause_size++;
         }
 
-        if(clause_size > max_clause_size) {
-            max_clause_size = clause_size;
-        }
-
         if(clause_size == 2) { // binary clause
             auto it = clause.begin();
             auto first_literal = *it; it++;
@@ -130,10 +124,18 @@ void read_input(std::unordered_map<int, std::unordered_set<int>>& formula, std::
         }
     }
 
-    fill_power_arrays_for_heustics(max_clause_size);
     #if DIFF_HEURISTIC >= 1
     count_weights(formula, literal_weights);
     #endif
 }
 
+// the widest clause decides which clause store the search uses
+int formula_max_clause_size(std::unordered_map<int, std::unordered_set<int>>& formula) {
+    int result = 0;
+    for(auto& clause: formula) {
+        result = std::max(result, (int) clause.second.size());
+    }
+    return result;
+}
+
 #endif
@@ -1,11 +1,26 @@
 #ifndef SAT_CLASS_H
 #define SAT_CLASS_H
 
-class SATclass {
+// copies the parsed formula into the clause type the search works on
+template<typename Clause>
+std::unordered_map<int, Clause> clause_store(std::unordered_map<int, std::unordered_set<int>>& formula) {
+    auto result = std::unordered_map<int, Clause>(formula.size());
+    for(auto& clause: formula) {
+        result.emplace(clause.first, Clause(clause.second.begin(), clause.second.end()));
+    }
+    return result;
+}
+
+/*
+    Clause is std::unordered_set<int>, or FixedClause<K> when no clause is
+    longer than K literals.
+*/
+template<typename Clause>
+class BasicSATclass {
 public:
     std::unordered_set<int> unsigned_variables;
     std::unordered_map<int, Variable> variables;
-    std::unordered_map<int, std::unordered_set<int>> formula;
+    std::unordered_map<int, Clause> formula;
     std::unordered_map<int, PairsSet> binary_clauses;
     std::unordered_map<int, double> literal_weights;
     std::unordered_set<int> satisfied_clauses;
@@ -13,22 +28,31 @@ public:
     std::unordered_set<int> reducted_clauses; //reducted clauses after propagation
     std::unordered_set<int> new_binary_clauses;
     std::unordered_set<int> implicated_variables;
+    PreselectHeap preselect_heap;
+    std::vector<int> changed_literals; // literals with new binary_clauses or literal_count since the last preselect
+    std::vector<bool> is_changed_literal; // by literal_index
     int number_of_all_clauses;
     int decision_level;
     double trigger;
     double start_tigger;
 
 
-    SATclass(std::unordered_set<int>& unsigned_variables, std::unordered_map<int, Variable>& variables,
+    BasicSATclass(std::unordered_set<int>& unsigned_variables, std::unordered_map<int, Variable>& variables,
              std::unordered_map<int, std::unordered_set<int>>& formula, std::unordered_map<int, PairsSet>& binary_clauses,
              int number_of_all_clauses, std::unordered_map<int, double>& literal_weights, std::unordered_map<int, int>& literal_count ) :
-            unsigned_variables(unsigned_variables), variables(variables), formula(formula), binary_clauses(binary_clauses),
+            unsigned_variables(unsigned_variables), variables(variables), formula(clause_store<Clause>(formula)), binary_clauses(binary_clauses),
             number_of_all_clauses(number_of_all_clauses), literal_weights(literal_weights),
             literal_count(literal_count), decision_level(0) {
         satisfied_clauses = {};
+        int number_of_variables = variables.size();
+        preselect_heap = PreselectHeap(number_of_variables);
+        is_changed_literal = std::vector<bool>(2*number_of_variables, false);
+        for(auto var: unsigned_variables) {
+            preselect_heap.update(var, preselect_score(var));
+        }
     }
     // Copy constructor
-    SATclass(const SATclass &p2) {
+    BasicSATclass(const BasicSATclass &p2) {
         number_of_all_clauses = p2.number_of_all_clauses;
         variables = p2.variables;
         unsigned_variables = p2.unsigned_variables;
@@ -38,13 +62,16 @@ public:
         satisfied_clauses = p2.satisfied_clauses;
         literal_weights = p2.literal_weights;
         literal_count = p2.literal_count;
+        preselect_heap = p2.preselect_heap;
+        changed_literals = p2.changed_literals;
+        is_changed_literal = p2.is_changed_literal;
         decision_level = p2.decision_level;
         trigger = p2.trigger;
         start_tigger = p2.start_tigger;
     }
 
     // Copy assignment operator
-    SATclass& operator=(SATclass p2)
+    BasicSATclass& operator=(BasicSATclass p2)
     {
         variables = p2.variables;
         unsigned_variables = p2.unsigned_variables;
@@ -55,23 +82,69 @@ public:
         number_of_all_clauses = p2.number_of_all_clauses;
         literal_weights = p2.literal_weights;
         literal_count = p2.literal_count;
+        preselect_heap = p2.preselect_heap;
+        changed_literals = p2.changed_literals;
+        is_changed_literal = p2.is_changed_literal;
         decision_level = p2.decision_level;
         trigger = p2.trigger;
         start_tigger = p2.start_tigger;
         return *this;
     }
 
+    void mark_changed_literal(int literal) {
+        auto index = literal_index(literal);
+        if(!is_changed_literal[index]) {
+            is_changed_literal[index] = true;
+            changed_literals.push_back(literal);
+        }
+    }
+
+    #if PRESELECT_HEURISTIC == 0
+    long long preselect_score(int var) {
+        return (long long) binary_clauses[var].size() * binary_clauses[-1*var].size();
+    }
+    #else
+    long long preselect_score(int var) {
+        long long positive_sum = 0;
+        long long negative_sum = 0;
+        for(auto i: binary_clauses[var]) {
+            positive_sum += literal_count[-1*i.first] - binary_clauses[-1*i.first].size();
+        }
+        for(auto i: binary_clauses[-1*var]) {
+            negative_sum += literal_count[-1*i.first] - binary_clauses[-1*i.first].size();
+        }
+        return positive_sum*negative_sum;
+    }
+    #endif
+
+    void refresh_preselect_score(int var) {
+        if(preselect_heap.contains(var)) {
+            preselect_heap.update(var, preselect_score(var));
+        }
+    }
+
+    // rescores only variables whose score depends on a changed literal
+    void refresh_preselect_scores() {
+        for(auto literal: changed_literals) {
+            is_changed_literal[literal_index(literal)] = false;
+            refresh_preselect_score(abs(literal));
+            #if PRESELECT_HEURISTIC == 1
+            for(auto i: binary_clauses[-1*literal]) { // cra score of a variable reads its binary neighbours
+                refresh_preselect_score(abs(i.first));
+            }
+            #endif
+        }
+        changed_literals.clear();
+    }
+
     std::unordered_set<int> preselect_propz() {
         if(decision_level < 5 || unsigned_variables.size() <= 10) {
             return unsigned_variables;
         }
 
+        refresh_preselect_scores();
         auto result_set = std::unordered_set<int>();
-        for(auto var: unsigned_variables) {
-            if(binary_clauses[var].size() > 0 && binary_clauses[-1*var].size() > 0) {
-                result_set.insert(var);
-            }
-        }
+        preselect_heap.collect_positive(result_set); // both literals appear in binary clauses
         auto it = unsigned_variables.begin();
         while(result_set.size() < 10 && it != unsigned_variables.end()) {
             result_set.insert(*it);
@@ -84,38 +157,102 @@ public:
         if(unsigned_variables.size() < 20) {
             return unsigned_variables;
         }
-        auto cra_map = std::unordered_map<int, int>();
 
+        refresh_preselect_scores();
         int unsigned_varialbes_count = unsigned_variables.size();
-        for(auto var: unsigned_variables) {
+        auto size = std::max(20, unsigned_varialbes_count/10);
+        auto result_set = std::unordered_set<int>();
+        preselect_heap.collect_top(size, result_set);
+        return result_set;
+    }
 
-            int positive_sum = 0;
-            int negative_sum = 0;
-            for(auto i: binary_clauses[var]) {
-                positive_sum += literal_count[-1*i.first] - binary_clauses[-1*i.first].size();
+    /*
+        Splits the remaining clauses into variable-disjoint groups. component_of
+        gets the group of every variable (-1 if it is in no clause), returns the
+        number of groups.
+    */
+    int find_components(std::vector<int>& component_of) {
+        int number_of_variables = variables.size();
+        auto parent = std::vector<int>(number_of_variables + 1);
+        for(int i=0; i<=number_of_variables; i++) {
+            parent[i] = i;
+        }
+        auto find = [&parent](int var) {
+            while(parent[var] != var) {
+                parent[var] = parent[parent[var]];
+                var = parent[var];
             }
-            for(auto i: binary_clauses[-1*var]) {
-                negative_sum += literal_count[-1*i.first] - binary_clauses[-1*i.first].size();
+            return var;
+        };
+        auto in_clause = std::vector<bool>(number_of_variables + 1, false);
+        for(auto& clause: formula) {
+            int first = abs(*clause.second.begin());
+            for(auto literal: clause.second) {
+                in_clause[abs(literal)] = true;
+                parent[find(abs(literal))] = find(first);
             }
+        }
 
-            cra_map[var] = positive_sum*negative_sum;
+        int number_of_components = 0;
+        auto component_of_root = std::vector<int>(number_of_variables + 1, -1);
+        component_of = std::vector<int>(number_of_variables + 1, -1);
+        for(int var=1; var<=number_of_variables; var++) {
+            if(in_clause[var]) {
+                int root = find(var);
+                if(component_of_root[root] == -1) {
+                    component_of_root[root] = number_of_components++;
+                }
+                component_of[var] = component_of_root[root];
+            }
         }
+        return number_of_components;
+    }
 
-        auto size = std::max(20, unsigned_varialbes_count/10);
-        std::vector<std::pair<int, int>> top(size);
-        auto result_set = std::unordered_set<int>();
-        std::partial_sort_copy(cra_map.begin(),
-                            cra_map.end(),
-                            top.begin(),
-                            top.end(),
-                            [](std::pair<int, int> const& l,
-                                std::pair<int, int> const& r)
-                            {
-                                return l.second > r.second;
-                            });
-        std::transform(top.begin(), top.end(), std::inserter(result_set, result_set.begin()),
-                   [](std::pair<int, int> c) { return c.first; });
-        return result_set;
+    // drops clauses and variables of all other components, they are solved separately
+    void keep_component(const std::vector<int>& component_of, int component) {
+        for(auto it = formula.begin(); it != formula.end();) {
+            int clause_hash = it->first;
+            if(component_of[abs(*it->second.begin())] != component) {
+                for(auto literal: it->second) {
+                    variables[abs(literal)].clauses.erase(clause_hash);
+                }
+                remove_from_reducted_if_there(clause_hash);
+                satisfied_clauses.insert(clause_hash);
+                it = formula.erase(it);
+            } else {
+                it++;
+            }
+        }
+        for(auto it = unsigned_variables.begin(); it != unsigned_variables.end();) {
+            if(component_of[*it] != component) {
+                preselect_heap.remove(*it);
+                it = unsigned_variables.erase(it);
+            } else {
+                it++;
+            }
+        }
+    }
+
+    /*
+        Collects the remaining binary clauses, returns true if there are no longer
+        ones left. With stop_at_long_clause the scan ends at the first longer clause.
+    */
+    bool residual_binary_clauses(std::vector<std::pair<int, int>>& clauses, bool stop_at_long_clause) {
+        bool only_binary = true;
+        for(auto& clause: formula) {
+            if(clause.second.size() > 2) {
+                only_binary = false;
+                if(stop_at_long_clause) {
+                    return false;
+                }
+            } else {
+                auto it = clause.second.begin();
+                int first_literal = *it;
+                int second_literal = clause.second.size() == 2 ? *(++it) : first_literal;
+                clauses.push_back(std::make_pair(first_literal, second_literal));
+            }
+        }
+        return only_binary;
     }
 
     bool is_satisfied() {
@@ -126,6 +263,23 @@ public:
         return formula[clause_hash].size();
     }
 
+    bool contains_clause(int clause_hash) {
+        return formula.find(clause_hash) != formula.end();
+    }
+
+    Clause& clause_literals(int clause_hash) {
+        return formula[clause_hash];
+    }
+
+    void add_learned_binary(int literal, int next_literal) {
+        formula[number_of_all_clauses] = {literal, next_literal};
+        binary_clauses[literal].insert(std::make_pair(next_literal, number_of_all_clauses));
+        binary_clauses[next_literal].insert(std::make_pair(literal, number_of_all_clauses));
+        mark_changed_literal(literal);
+        mark_changed_literal(next_literal);
+        number_of_all_clauses += 1;
+    }
+
     int get_satified_literal(std::pair<int, int> new_value) {
         if(new_value.second == 0) {
             return -1*new_value.first;
@@ -145,12 +299,13 @@ public:
     void prepare_satisfied_clause(int clause_hash) {
         auto& clause = formula[clause_hash];
         #if DIFF_HEURISTIC >= 1
-        double coeff = powers[clause.size()];
+        double coeff = clause_power(clause.size());
         #endif
         for(auto literal: clause) {
             variables[abs(literal)].clauses.erase(clause_hash);
             #if DIRECTION_HEURISTIC == 0 || AUTARKY_REASONING == 1
             literal_count[literal] -= 1;
+            mark_changed_literal(literal);
             #endif
             #if DIFF_HEURISTIC >= 1
             literal_weights[literal] -= coeff;
@@ -177,6 +332,8 @@ public:
 
         binary_clauses[first_literal].insert(std::make_pair(second_literal, clause_hash));
         binary_clauses[second_literal].insert(std::make_pair(first_literal, clause_hash));
+        mark_changed_literal(first_literal);
+        mark_changed_literal(second_literal);
         for(auto literal: formula[clause_hash]) {
             variables[abs(literal)].clauses.erase(clause_hash);
         }
@@ -191,6 +348,7 @@ public:
 
         #if DIRECTION_HEURISTIC == 0 || AUTARKY_REASONING == 1
         literal_count[literal] -= binary_clauses[literal].size();
+        mark_changed_literal(literal);
         #endif
 
         for(auto i: binary_clauses[literal]) {
@@ -245,6 +403,7 @@ public:
             auto var = assigned_variables.top();
             assigned_variables.pop();
             unsigned_variables.erase(var.first);
+            preselect_heap.remove(var.first);
 
             auto newly_satisfied_clauses = std::vector<int>();
             auto newly_created_binary_clauses = std::vector<int>();
@@ -260,6 +419,7 @@ public:
 
                     #if DIRECTION_HEURISTIC == 0 || AUTARKY_REASONING == 1
                     literal_count[literal] -= 1;
+                    mark_changed_literal(literal);
                     #endif
 
                     if(formula[clause_hash].size() == 2) {
@@ -294,5 +454,6 @@ public:
     }
 };
 
+using SATclass = BasicSATclass<std::unordered_set<int>>;
 
 #endif
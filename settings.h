@@ -72,4 +72,90 @@
         1 use local learning
 */
 
-#endif
\ No newline at end of file
+#endif
+
+#ifndef CHECKPOINT_INTERVAL
+#define CHECKPOINT_INTERVAL 0
+
+/*
+    possible values:
+        0 don't write checkpoints
+        > 0 seconds between two checkpoints of the search, written to --checkpoint <file>
+            (solver.checkpoint by default, so parallel runs in one directory need their own files)
+*/
+
+#endif
+
+
+#ifndef BIT_ENGINE_MAX_VARIABLES
+#define BIT_ENGINE_MAX_VARIABLES 256
+
+/*
+    possible values:
+        0 always use SATclass
+        > 0 formulas with at most this many variables are solved with the bit vector engine (BitSATclass)
+*/
+
+#endif
+
+
+#ifndef COMPONENT_DECOMPOSITION
+#define COMPONENT_DECOMPOSITION 1
+
+/*
+    possible values:
+        0 don't split the formula into components
+        > 0 check for variable-disjoint components every COMPONENT_DECOMPOSITION decision levels
+            and solve them separately
+    Only SATclass splits, the bit engine always searches the whole formula.
+    No splitting (and no worker threads) while checkpoints are written or --resume replays one.
+*/
+
+#endif
+
+#ifndef COMPONENT_PARALLEL_MIN_VARIABLES
+#define COMPONENT_PARALLEL_MIN_VARIABLES 100
+
+/*
+    components with at least this many unsigned variables are solved on worker threads
+*/
+
+#endif
+
+
+#ifndef TWO_SAT
+#define TWO_SAT 1
+
+/*
+    possible values:
+        0 don't use the binary implication graph
+        1 solve the remaining formula with SCC when only binary clauses are left
+        2 also use SCC before every look-ahead: set failed literals, look at one variable per group of equivalent ones
+*/
+
+#endif
+
+
+#ifndef LOCAL_SEARCH
+#define LOCAL_SEARCH 0
+
+/*
+    possible values:
+        0 don't use local search
+        1 run probSAT on another thread next to the look-ahead search, the first one to finish wins
+        2 like 1, dpll also takes the first branch of a decision from the best probSAT assignment so far
+*/
+
+#endif
+
+
+#ifndef FIXED_CLAUSE_STORE
+#define FIXED_CLAUSE_STORE 1
+
+/*
+    possible values:
+        0 keep every clause in an unordered_set
+        1 keep clauses in inline arrays of width 3, 5 or 7 when no clause is longer
+*/
+
+#endif
@@ -0,0 +1,634 @@
+#ifndef SOLVER_H
+#define SOLVER_H
+
+/*
+    Returns:
+    0 -> instance is unsatisfable
+    -1 -> decision variable was not found
+    > 0 -> decision varible
+
+*/
+// per thread, components may be searched in parallel
+thread_local bool last_decision_true_is_better = false;
+thread_local bool march_true_is_better = false;
+
+// only the main thread writes checkpoints, parallel components are not part of them
+thread_local std::vector<Decision> decision_path; // decisions from the root to the current node
+thread_local Checkpoint resume_checkpoint; // path still to replay, and the state to restore after it
+thread_local size_t resume_position = 0;
+thread_local CheckpointWriter* checkpoint_writer = nullptr;
+uint64_t checkpoint_fingerprint = 0;
+auto last_checkpoint = std::chrono::steady_clock::now();
+
+// set when a sibling component turned out unsatisfiable, the search below it can stop
+struct CancelToken {
+    std::atomic<bool> cancelled;
+    const CancelToken* parent;
+
+    bool is_cancelled() const {
+        return cancelled.load(std::memory_order_relaxed) || (parent != nullptr && parent->is_cancelled());
+    }
+};
+
+thread_local const CancelToken* search_cancel_token = nullptr;
+std::atomic<int> busy_component_workers(0);
+
+template<typename Instance>
+int look_ahead(Instance& instance, int depth);
+
+template<typename Instance>
+void prepare_trigger(Instance& instance, int number_of_variables) {
+    #if DOUBLE_LOOKAHEAD == 1
+        instance.trigger = 65;
+    #elif DOUBLE_LOOKAHEAD == 2 || DOUBLE_LOOKAHEAD == 3
+        instance.trigger = 0.17*number_of_variables;
+        instance.start_tigger = 0.17*number_of_variables;
+    #elif DOUBLE_LOOKAHEAD == 4
+        instance.trigger = 0;
+    #endif
+    #if DOUBLE_LOOKAHEAD != 2 && DOUBLE_LOOKAHEAD != 3
+        (void) number_of_variables;
+    #endif
+}
+
+template<typename Instance>
+int double_lookahead(Instance& instance, Instance& old_instance) {
+    #if DOUBLE_LOOKAHEAD >= 1
+        auto binary_clauses = instance.new_binary_clauses.size();
+        //std::cout << binary_clauses << ' ' << old_instance.trigger << '\n'; 
+        if(binary_clauses >= old_instance.trigger) {
+            auto next_look_ahed_result = look_ahead(instance, 2);
+            if (next_look_ahed_result == 0) {
+                #if DOUBLE_LOOKAHEAD == 3
+                    old_instance.trigger = old_instance.start_tigger;
+                #endif
+                return 0;
+            } else {
+                #if DOUBLE_LOOKAHEAD == 3 || DOUBLE_LOOKAHEAD == 4
+                    old_instance.trigger = binary_clauses;
+                #endif
+            }
+        }
+    #endif
+    return 1;
+}
+
+template<typename Instance>
+double count_crh(Instance& old_instace, Instance& instance) {
+    double result = 0;
+    for(auto clause_hash: instance.reducted_clauses) {
+        if(instance.contains_clause(clause_hash)) {
+            result += clause_power(instance.get_clause_size(clause_hash));
+        } else {
+            result += 1; // binary clause;
+        }
+        
+    }
+    return result;
+}
+
+template<typename Instance>
+void recount_weights(Instance& instance, Instance& new_instace) {
+    for(auto hash: new_instace.reducted_clauses) {
+        double new_coeff = clause_power(new_instace.get_clause_size(hash));
+        double old_coeff = clause_power(instance.get_clause_size(hash));
+        double update = new_coeff - old_coeff;
+        for(auto literal: new_instace.clause_literals(hash)) {
+            new_instace.literal_weights[literal] += update;
+        }
+    }
+}
+
+template<typename Instance>
+double count_wbh(Instance& instance, Instance& new_instace) {
+    recount_weights(instance, new_instace);
+    double wbh = 0;
+    for(auto i: new_instace.reducted_clauses) {
+        if(new_instace.get_clause_size(i) == 2) {
+            for(auto literal: new_instace.clause_literals(i)) {
+                wbh += new_instace.literal_weights[-1*literal];
+            }
+        }
+    }
+    return wbh;
+}
+
+template<typename Instance>
+double count_bsh(Instance& instance, Instance& new_instace) {
+    recount_weights(instance, new_instace);
+    double bsh = 0;
+    for(auto i: new_instace.reducted_clauses) {
+        if(new_instace.get_clause_size(i) == 2) {
+            double result = 1;
+            for(auto literal: new_instace.clause_literals(i)) {
+                result *= new_instace.literal_weights[-1*literal];
+            }
+            bsh += result;
+        }
+    }
+    return bsh;
+}
+
+template<typename Clause, typename Weights>
+double negated_weight_sum(const Clause& clause, Weights& literal_weights) {
+    double result = 0;
+    for(auto literal: clause) {
+        result += literal_weights[-1*literal];
+    }
+    return result;
+}
+
+// fixed trip count, the compiler unrolls it for each width
+template<int K, typename Weights>
+double negated_weight_sum(const FixedClause<K>& clause, Weights& literal_weights) {
+    double result = 0;
+    for(int j=0; j<K; j++) {
+        if(j < clause.size()) {
+            result += literal_weights[-1*clause[j]];
+        }
+    }
+    return result;
+}
+
+template<typename Clause, typename Weights>
+double normalized_weight_product(const Clause& clause, Weights& literal_weights, double normalization) {
+    double result = 1;
+    for(auto literal: clause) {
+        result *= literal_weights[-1*literal]/normalization;
+    }
+    return result;
+}
+
+template<int K, typename Weights>
+double normalized_weight_product(const FixedClause<K>& clause, Weights& literal_weights, double normalization) {
+    double result = 1;
+    for(int j=0; j<K; j++) {
+        if(j < clause.size()) {
+            result *= literal_weights[-1*clause[j]]/normalization;
+        }
+    }
+    return result;
+}
+
+template<typename Instance>
+double count_bsrh(Instance& instance, Instance& new_instace) {
+    recount_weights(instance, new_instace);
+    
+    double total_size = 0;
+    double coeff_sum = 0;
+    for(auto i: new_instace.reducted_clauses) {
+        auto&& clause = new_instace.clause_literals(i);
+        coeff_sum += negated_weight_sum(clause, new_instace.literal_weights);
+        total_size += clause.size();
+    }
+    double normalization = coeff_sum/total_size;
+    double bsrh = 0;
+    for(auto i: new_instace.reducted_clauses) {
+        auto&& clause = new_instace.clause_literals(i);
+        bsrh += clause_power(clause.size())*normalized_weight_product(clause, new_instace.literal_weights, normalization);
+    }
+    return bsrh;
+}
+
+
+template<typename Instance>
+double decision_heuristic(Instance& instance, Instance& true_instace, Instance& false_instance) {
+    #if DIFF_HEURISTIC == 0
+    auto function_pointer = count_crh<Instance>;
+    #elif DIFF_HEURISTIC == 1
+    auto function_pointer = count_wbh<Instance>;
+    #elif DIFF_HEURISTIC == 2
+    auto function_pointer = count_bsh<Instance>;
+    #elif DIFF_HEURISTIC == 3
+    auto function_pointer = count_bsrh<Instance>;
+    #endif
+    double true_result = function_pointer(instance, true_instace);
+    double false_result = function_pointer(instance, false_instance);
+    #if DIRECTION_HEURISTIC == 1
+    last_decision_true_is_better = true_result > false_result;
+    #endif
+    return true_result*false_result;
+}
+
+
+template<typename Instance>
+bool kcnfs_direction(Instance& instance, int decision_variable) {
+    return instance.literal_count[decision_variable] > instance.literal_count[-1*decision_variable];
+}
+
+bool march_direction() {
+    return !march_true_is_better;
+}
+
+template<typename Instance>
+bool posit_direction(Instance& instance, int decision_variable) {
+    return instance.literal_weights[decision_variable] < instance.literal_weights[-1*decision_variable];
+}
+
+template<typename Instance>
+bool get_direction_heuristic_val(Instance& instance, int decision_variable) {
+    #if LOCAL_SEARCH == 2
+    bool local_search_value;
+    if(local_search_phases.get(decision_variable, local_search_value)) {
+        return local_search_value;
+    }
+    #endif
+    #if DIRECTION_HEURISTIC == 0
+    return kcnfs_direction(instance, decision_variable);
+    #elif DIRECTION_HEURISTIC == 1
+    return march_direction();
+    #elif DIRECTION_HEURISTIC == 2
+    return posit_direction(instance, decision_variable);
+    #elif DIRECTION_HEURISTIC == 3
+    return true;
+    #endif
+}
+
+template<typename Instance>
+void prepare_binary_clauses(Instance& instance, Instance& after_propagation, int variable, bool value) {
+    int literal = value ? -1*variable : variable;
+
+    for(auto var: after_propagation.implicated_variables) {
+        auto next_literal = after_propagation.variables[var].value ? var : -1*var;
+        instance.add_learned_binary(literal, next_literal);
+    }
+}
+
+/*
+    Returns:
+    -1 -> remaining formula has longer clauses, or the SCC model does not satisfy it
+    0 -> remaining 2-SAT formula is unsatisfable
+    1 -> remaining 2-SAT formula is satisfable
+*/
+template<typename Instance>
+int solve_two_sat(Instance& instance) {
+    auto clauses = std::vector<std::pair<int, int>>();
+    if(!instance.residual_binary_clauses(clauses, true)) {
+        return -1;
+    }
+    auto graph = ImplicationGraph(clauses);
+    if(graph.is_contradictory()) {
+        return 0;
+    }
+    // the SCC model has to satisfy every residual clause, otherwise the search goes on
+    auto model = graph.model();
+    for(auto& clause: clauses) {
+        if(model[abs(clause.first)] != (clause.first > 0) && model[abs(clause.second)] != (clause.second > 0)) {
+            return -1;
+        }
+    }
+    return 1;
+}
+
+/*
+    SCC pass over the binary clauses before the look-ahead. Failed literals
+    are set to false, equivalent_class gets one class per group of equivalent
+    variables. Returns false if the binary clauses are unsatisfable.
+*/
+template<typename Instance>
+bool binary_equivalence_reasoning(Instance& instance, std::vector<int>& equivalent_class) {
+    auto clauses = std::vector<std::pair<int, int>>();
+    instance.residual_binary_clauses(clauses, false);
+    auto graph = ImplicationGraph(clauses);
+    if(graph.is_contradictory()) {
+        return false;
+    }
+    for(auto literal: graph.failed_literals()) {
+        if(instance.variables[abs(literal)].value == -1 && !instance.propagation(abs(literal), literal < 0)) {
+            return false;
+        }
+    }
+    equivalent_class = std::vector<int>(graph.component.size()/2 + 1, -1);
+    for(size_t var=1; var<equivalent_class.size(); var++) {
+        int component = graph.component_of(var);
+        if(component != -1) {
+            equivalent_class[var] = std::min(component, graph.component_of(-1*var));
+        }
+    }
+    return true;
+}
+
+template<typename Instance>
+int look_ahead(Instance& instance, int depth) {
+    #if TWO_SAT == 2
+    auto equivalent_class = std::vector<int>();
+    auto looked_at_class = std::unordered_set<int>();
+    if(depth == 0 && !binary_equivalence_reasoning(instance, equivalent_class)) {
+        return 0;
+    }
+    #endif
+    #if PRESELECT_HEURISTIC == 0
+    auto preselect = instance.preselect_propz();
+    #else
+    auto preselect = instance.preselect_cra();
+    #endif
+    int selected_var = -1;
+    double decision_heuristic_value = -100;
+    for(auto i: preselect) {
+        if(search_cancel_token != nullptr && search_cancel_token->is_cancelled()) {
+            return 0; // result is not needed anymore
+        }
+        if(instance.variables[i].value == -1) {
+            #if TWO_SAT == 2
+                // equivalent variables propagate the same, looking at one of them is enough
+                if(i < static_cast<int>(equivalent_class.size()) && equivalent_class[i] != -1
+                   && !looked_at_class.insert(equivalent_class[i]).second) {
+                    continue;
+                }
+            #endif
+            #if AUTARKY_REASONING != 0
+                if(instance.literal_count[i] == 0) { // positive literal does not appear
+                    instance.propagation(i, 0);
+                    continue;
+                } else if(instance.literal_count[-1*i] == 0) { // negative literal does not apper
+                    instance.propagation(i, 1);
+                    continue;
+                }
+            #endif
+
+            auto result_of_true_instance = instance;
+            auto result_of_false_instance = instance;
+
+            bool true_propagation = result_of_true_instance.propagation(i, 1);
+            #if LOCAL_LEARNING == 1
+                prepare_binary_clauses(instance, result_of_true_instance, i, true);
+            #endif
+            bool false_propagation = result_of_false_instance.propagation(i, 0);
+            #if LOCAL_LEARNING == 1
+                prepare_binary_clauses(instance, result_of_false_instance, i, false);
+            #endif
+            if(!true_propagation && !false_propagation) {
+                return 0;
+            } else if(!true_propagation) {
+                instance = result_of_false_instance;
+                #if DOUBLE_LOOKAHEAD > 0
+                    if(depth == 0) {
+                        auto new_look_ahead_result = double_lookahead(instance, instance);
+                        if (new_look_ahead_result == 0) {
+                            return 0;
+                        }
+                    }
+                #endif
+            } else if(!false_propagation) {
+                instance = result_of_true_instance;
+                #if DOUBLE_LOOKAHEAD > 0
+                    if(depth == 0) {
+                        auto new_look_ahead_result = double_lookahead(instance, instance);
+                        if (new_look_ahead_result == 0) {
+                            return 0;
+                        }
+                    }
+                #endif
+            } else {
+
+                #if DOUBLE_LOOKAHEAD > 0
+                    if(depth == 0) {
+                        auto double_for_true = double_lookahead(result_of_true_instance, instance);
+                        auto double_for_false = double_lookahead(result_of_false_instance, instance);
+                        if(double_for_true == 0 && double_for_false == 0) {
+                            return 0;
+                        }
+                    }
+                #endif
+
+                auto new_decision = decision_heuristic(instance, result_of_true_instance, result_of_false_instance);
+                if(new_decision > decision_heuristic_value) {
+                    decision_heuristic_value = new_decision;
+                    selected_var = i;
+                    #if DIRECTION_HEURISTIC == 1
+                        march_true_is_better = last_decision_true_is_better;
+                    #endif
+                }
+            }
+        }
+    }
+    #if DOUBLE_LOOKAHEAD == 4
+        if(instance.trigger > 0) {
+            instance.trigger--;
+        }
+    #endif
+
+    if(selected_var > 0 && instance.variables[selected_var].value != -1) {
+        return -1;
+    }
+    return selected_var;
+}
+
+
+bool is_replaying() {
+    return resume_position < resume_checkpoint.path.size();
+}
+
+template<typename Instance>
+void save_checkpoint_if_due(Instance& instance) {
+    #if CHECKPOINT_INTERVAL > 0
+        if(checkpoint_writer == nullptr || is_replaying()) {
+            return;
+        }
+        auto now = std::chrono::steady_clock::now();
+        if(now - last_checkpoint >= std::chrono::seconds(CHECKPOINT_INTERVAL)) {
+            last_checkpoint = now;
+            checkpoint_writer->submit({checkpoint_fingerprint, march_true_is_better, instance.trigger, decision_path});
+        }
+    #else
+        (void) instance;
+    #endif
+}
+
+template<typename Instance>
+bool dpll(Instance instance);
+
+/*
+    Returns:
+    -1 -> remaining formula is connected, or splitting is not supported for this instance
+    0 -> some component is unsatisfiable
+    1 -> all components are satisfiable
+*/
+template<typename Instance>
+int solve_components(Instance&) {
+    return -1;
+}
+
+template<typename Clause>
+int solve_components(BasicSATclass<Clause>& instance) {
+    if(checkpoint_writer != nullptr || is_replaying()) {
+        return -1; // the decision path can't describe a split, checkpoints would not match the search
+    }
+    auto component_of = std::vector<int>();
+    int number_of_components = instance.find_components(component_of);
+    if(number_of_components <= 1) {
+        return -1;
+    }
+
+    auto component_size = std::vector<int>(number_of_components, 0);
+    for(auto var: instance.unsigned_variables) {
+        if(component_of[var] != -1) {
+            component_size[component_of[var]] += 1;
+        }
+    }
+
+    CancelToken token;
+    token.cancelled = false;
+    token.parent = search_cancel_token;
+    int max_workers = std::max(0, (int) std::thread::hardware_concurrency() - 1);
+    auto workers = std::vector<std::future<bool>>();
+    auto inline_components = std::vector<int>();
+
+    // large components go to free workers, the rest is searched on this thread
+    for(int component=0; component<number_of_components; component++) {
+        if(component_size[component] < COMPONENT_PARALLEL_MIN_VARIABLES || busy_component_workers.fetch_add(1) >= max_workers) {
+            if(component_size[component] >= COMPONENT_PARALLEL_MIN_VARIABLES) {
+                busy_component_workers.fetch_sub(1);
+            }
+            inline_components.push_back(component);
+            continue;
+        }
+        auto component_instance = instance;
+        component_instance.keep_component(component_of, component);
+        workers.push_back(std::async(std::launch::async, [&token](BasicSATclass<Clause> component_instance) {
+            search_cancel_token = &token;
+            bool result = dpll(component_instance);
+            if(!result) {
+                token.cancelled = true;
+            }
+            busy_component_workers.fetch_sub(1);
+            return result;
+        }, std::move(component_instance)));
+    }
+
+    auto previous_token = search_cancel_token;
+    search_cancel_token = &token;
+    bool result = true;
+    for(auto component: inline_components) {
+        auto component_instance = instance;
+        component_instance.keep_component(component_of, component);
+        if(!dpll(component_instance)) {
+            token.cancelled = true;
+            result = false;
+            break;
+        }
+    }
+    search_cancel_token = previous_token;
+
+    for(auto& worker: workers) {
+        result = worker.get() && result;
+    }
+    return result ? 1 : 0;
+}
+
+template<typename Instance>
+bool dpll(Instance instance) {
+    if(search_cancel_token != nullptr && search_cancel_token->is_cancelled()) {
+        return false;
+    }
+    instance.decision_level += 1;
+    save_checkpoint_if_due(instance);
+    if (instance.is_satisfied()) {
+        return true;
+    } else {
+        #if TWO_SAT >= 1
+            int two_sat_result = solve_two_sat(instance);
+            if(two_sat_result != -1) {
+                return two_sat_result == 1;
+            }
+        #endif
+        #if COMPONENT_DECOMPOSITION > 0
+            if(instance.decision_level % COMPONENT_DECOMPOSITION == 0) {
+                int components_result = solve_components(instance);
+                if(components_result != -1) {
+                    return components_result == 1;
+                }
+            }
+        #endif
+
+        int decision_variable = look_ahead(instance, 0);
+        if (decision_variable == 0) {
+            return false;
+        } else if (decision_variable == -1) {
+            return dpll(instance);
+        } else {
+            auto instance_copy = instance;
+            bool value = get_direction_heuristic_val(instance, decision_variable);
+            bool second_branch = false;
+            if(is_replaying()) {
+                auto& decision = resume_checkpoint.path[resume_position];
+                if(decision.variable == decision_variable) {
+                    value = decision.value;
+                    second_branch = decision.second_branch;
+                    resume_position++;
+                    if(!is_replaying()) {
+                        // replayed look-aheads rebuild learned binaries, the rest is restored here
+                        march_true_is_better = resume_checkpoint.march_true_is_better;
+                        instance.trigger = resume_checkpoint.trigger;
+                        instance_copy.trigger = resume_checkpoint.trigger;
+                    }
+                } else {
+                    std::cerr << "checkpoint does not match the search, continuing without it\n";
+                    resume_checkpoint.path.clear();
+                }
+            }
+            decision_path.push_back({decision_variable, value, second_branch});
+            if(!second_branch) {
+                bool propagarion_res = instance.propagation(decision_variable, value);
+                if(propagarion_res && dpll(instance)) {
+                    decision_path.pop_back(); // a satisfied component returns to its siblings
+                    return true;
+                }
+                decision_path.back().second_branch = true;
+            }
+            bool propagarion_res = instance_copy.propagation(decision_variable, !value);
+            bool result = propagarion_res && dpll(instance_copy);
+            decision_path.pop_back();
+            return result;
+        }
+    }
+}
+
+// start assignment for the local search, from the static direction heuristics
+template<typename Instance>
+std::vector<bool> local_search_start_phases(Instance& instance, int number_of_variables) {
+    auto phases = std::vector<bool>(number_of_variables + 1, false);
+    for(int var=1; var<=number_of_variables; var++) {
+        #if DIRECTION_HEURISTIC == 2
+        phases[var] = posit_direction(instance, var);
+        #else
+        phases[var] = kcnfs_direction(instance, var);
+        #endif
+    }
+    return phases;
+}
+
+/*
+    Runs the local search on another thread next to dpll. Whichever finishes
+    first stops the other one.
+*/
+template<typename Instance>
+bool search_with_local_search(Instance& instance, ProbSAT& local_search, int number_of_variables) {
+    CancelToken token;
+    token.cancelled = false;
+    token.parent = nullptr;
+    std::atomic<bool> stop_local_search(false);
+    bool local_search_result = false;
+    auto phases = local_search_start_phases(instance, number_of_variables);
+
+    std::thread local_search_thread([&] {
+        #if LOCAL_SEARCH == 2
+        SharedPhases* shared_phases = &local_search_phases;
+        #else
+        SharedPhases* shared_phases = nullptr;
+        #endif
+        local_search_result = local_search.solve(phases, stop_local_search, shared_phases);
+        if(local_search_result) {
+            token.cancelled = true;
+        }
+    });
+
+    search_cancel_token = &token;
+    bool result = dpll(instance);
+    search_cancel_token = nullptr;
+    stop_local_search = true;
+    local_search_thread.join();
+    return result || local_search_result;
+}
+
+#endif
@@ -0,0 +1,175 @@
+#ifndef TWO_SAT_H
+#define TWO_SAT_H
+
+#include "includes.h"
+
+/*
+    Implication graph of the binary clauses: clause (a, b) gives edges
+    -a -> b and -b -> a. Nodes are literal_index of literals.
+    Strongly connected components are found with an iterative Tarjan pass,
+    components are numbered in reverse topological order.
+*/
+class ImplicationGraph {
+public:
+    int number_of_components;
+    std::vector<int> component; // by literal_index, -1 for literals in no binary clause
+
+    ImplicationGraph(const std::vector<std::pair<int, int>>& clauses) : number_of_components(0) {
+        int number_of_nodes = 0;
+        for(auto& clause: clauses) {
+            number_of_nodes = std::max(number_of_nodes, 2*std::max(abs(clause.first), abs(clause.second)));
+        }
+        edges_start = std::vector<int>(number_of_nodes + 1, 0);
+        for(auto& clause: clauses) {
+            edges_start[literal_index(-1*clause.first) + 1] += 1;
+            edges_start[literal_index(-1*clause.second) + 1] += 1;
+        }
+        for(int i=0; i<number_of_nodes; i++) {
+            edges_start[i + 1] += edges_start[i];
+        }
+        edges = std::vector<int>(edges_start[number_of_nodes]);
+        auto position = std::vector<int>(edges_start.begin(), edges_start.end() - 1);
+        for(auto& clause: clauses) {
+            edges[position[literal_index(-1*clause.first)]++] = literal_index(clause.second);
+            edges[position[literal_index(-1*clause.second)]++] = literal_index(clause.first);
+        }
+        component = std::vector<int>(number_of_nodes, -1);
+        find_components(number_of_nodes);
+    }
+
+    int component_of(int literal) const {
+        int index = literal_index(literal);
+        return index < static_cast<int>(component.size()) ? component[index] : -1;
+    }
+
+    // some literal is equivalent to its negation
+    bool is_contradictory() const {
+        for(size_t i=0; i<component.size(); i+=2) {
+            if(component[i] != -1 && component[i] == component[i + 1]) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // a literal is true if its component comes after the negation's in topological order
+    std::vector<bool> model() const {
+        auto result = std::vector<bool>(component.size()/2 + 1, false);
+        for(size_t i=0; i<component.size(); i+=2) {
+            result[i/2 + 1] = component[i] < component[i + 1];
+        }
+        return result;
+    }
+
+    /*
+        Literals l that imply both some literal and its negation, or imply -l,
+        looking at the components directly reachable from the component of l.
+    */
+    std::vector<int> failed_literals() const {
+        auto negation = std::vector<int>(number_of_components, -1); // component of the negated literals
+        for(size_t i=0; i<component.size(); i++) {
+            if(component[i] != -1) {
+                negation[component[i]] = component[i ^ 1];
+            }
+        }
+        auto members = std::vector<std::vector<int>>(number_of_components);
+        for(size_t i=0; i<component.size(); i++) {
+            if(component[i] != -1) {
+                members[component[i]].push_back(i);
+            }
+        }
+
+        auto result = std::vector<int>();
+        auto mark = std::vector<int>(number_of_components, -1);
+        auto reached = std::vector<int>();
+        for(int c=0; c<number_of_components; c++) {
+            reached.clear();
+            mark[c] = c;
+            reached.push_back(c);
+            for(auto node: members[c]) {
+                for(int j=edges_start[node]; j<edges_start[node + 1]; j++) {
+                    int next = component[edges[j]];
+                    if(mark[next] != c) {
+                        mark[next] = c;
+                        reached.push_back(next);
+                    }
+                }
+            }
+            bool failed = false;
+            for(auto d: reached) {
+                if(negation[d] != -1 && mark[negation[d]] == c) {
+                    failed = true;
+                    break;
+                }
+            }
+            if(failed) {
+                for(auto node: members[c]) {
+                    result.push_back(node % 2 == 0 ? node/2 + 1 : -(node/2 + 1));
+                }
+            }
+        }
+        return result;
+    }
+
+private:
+    std::vector<int> edges_start; // CSR adjacency
+    std::vector<int> edges;
+
+    void find_components(int number_of_nodes) {
+        auto index = std::vector<int>(number_of_nodes, -1);
+        auto low = std::vector<int>(number_of_nodes, 0);
+        auto on_stack = std::vector<bool>(number_of_nodes, false);
+        auto stack = std::vector<int>();
+        auto call_stack = std::vector<std::pair<int, int>>(); // node, next edge
+        int counter = 0;
+
+        for(int start=0; start<number_of_nodes; start++) {
+            if(index[start] != -1 || edges_start[start] == edges_start[start + 1]) {
+                continue; // visited, or no outgoing edges: checked when reached
+            }
+            call_stack.push_back(std::make_pair(start, edges_start[start]));
+            index[start] = low[start] = counter++;
+            stack.push_back(start);
+            on_stack[start] = true;
+            while(!call_stack.empty()) {
+                int node = call_stack.back().first;
+                int& edge = call_stack.back().second;
+                if(edge < edges_start[node + 1]) {
+                    int next = edges[edge++];
+                    if(index[next] == -1) {
+                        index[next] = low[next] = counter++;
+                        stack.push_back(next);
+                        on_stack[next] = true;
+                        call_stack.push_back(std::make_pair(next, edges_start[next]));
+                    } else if(on_stack[next]) {
+                        low[node] = std::min(low[node], index[next]);
+                    }
+                    continue;
+                }
+                if(low[node] == index[node]) {
+                    int member;
+                    do {
+                        member = stack.back();
+                        stack.pop_back();
+                        on_stack[member] = false;
+                        component[member] = number_of_components;
+                    } while(member != node);
+                    number_of_components++;
+                }
+                call_stack.pop_back();
+                if(!call_stack.empty()) {
+                    int parent = call_stack.back().first;
+                    low[parent] = std::min(low[parent], low[node]);
+                }
+            }
+        }
+        // literals of binary clauses without outgoing edges are components on their own
+        for(int i=0; i<number_of_nodes; i++) {
+            if(component[i] == -1 && (component[i ^ 1] != -1 || edges_start[i ^ 1] != edges_start[(i ^ 1) + 1])) {
+                component[i] = number_of_components++;
+            }
+        }
+    }
+};
+
+#endif
@@ -11,6 +11,11 @@ struct Variable
     friend std::ostream & operator << (std::ostream &out, const Variable &c);
 };
 
+// position of a literal in arrays indexed by literals: 2(l-1) for l > 0, 2(-l-1)+1 for l < 0
+int literal_index(int literal) {
+    return literal > 0 ? 2*(literal - 1) : 2*(-literal - 1) + 1;
+}
+
 std::ostream & operator << (std::ostream &out, const Variable &c) {
     out << "value: " << c.value << " level: " << c.assigned_level << " clauses: [ ";
     for(auto i: c.clauses) {